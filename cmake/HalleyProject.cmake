@@ -31,6 +31,12 @@ if (DEV_BUILD EQUAL 1)
 	add_definitions(-DDEV_BUILD)
 endif()
 
+# Heap instrumentation, replaces global operator new/delete (see halley/support/memory_tracker.h)
+set(HALLEY_TRACK_ALLOCATIONS 0 CACHE BOOL "Track heap allocations by subsystem")
+if (HALLEY_TRACK_ALLOCATIONS)
+	add_definitions(-DHALLEY_TRACK_ALLOCATIONS)
+endif()
+
 
 # C++14 support
 set(CMAKE_CXX_STANDARD 14)
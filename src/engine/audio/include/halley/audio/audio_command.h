@@ -0,0 +1,50 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <functional>
+
+namespace Halley {
+	// Fixed-size command sent from the game thread to the audio thread.
+	// Common per-frame operations are plain data; anything else is carried as a heap-allocated Action.
+	struct AudioCommand {
+		enum class Type : uint8_t {
+			Action,
+			SetGain,
+			SetPosition,
+			SetPan,
+			Stop,
+			SetMasterGain,
+			SetListener
+		};
+
+		Type type = Type::Action;
+		size_t id = 0;
+		std::array<float, 4> params;
+		std::function<void()>* action = nullptr; // Owned by the command, only set for Type::Action
+
+		AudioCommand() = default;
+		AudioCommand(Type type, size_t id, std::array<float, 4> params = {}, std::function<void()>* action = nullptr)
+			: type(type)
+			, id(id)
+			, params(params)
+			, action(action)
+		{}
+	};
+
+	// Sent from the audio thread back to the game thread
+	struct AudioNotification {
+		enum class Type : uint8_t {
+			SoundStarted,
+			SoundFinished
+		};
+
+		Type type = Type::SoundStarted;
+		size_t id = 0;
+
+		AudioNotification() = default;
+		AudioNotification(Type type, size_t id)
+			: type(type)
+			, id(id)
+		{}
+	};
+}
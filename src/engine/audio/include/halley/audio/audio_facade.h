@@ -4,6 +4,8 @@
 #include <atomic>
 #include <vector>
 #include "halley/core/api/halley_api_internal.h"
+#include "halley/concurrency/spsc_queue.h"
+#include "audio_command.h"
 #include <map>
 
 namespace Halley {
@@ -56,18 +58,17 @@ namespace Halley {
 		std::unique_ptr<AudioEngine> engine;
 
 		std::thread audioThread;
-		std::mutex audioMutex;
 		std::mutex exceptionMutex;
 		std::atomic<bool> running;
 		std::atomic<bool> started;
 	    AudioSpec audioSpec;
 
-		std::vector<std::function<void()>> outbox;
-		std::vector<std::function<void()>> inbox;
-		std::vector<std::function<void()>> inboxProcessing;
+		SPSCQueue<AudioCommand> commands;
+		SPSCQueue<AudioNotification> notifications;
+		std::vector<AudioCommand> outbox; // Game thread only, commands that haven't been handed to the audio thread yet
+		std::vector<AudioNotification> pendingNotifications; // Audio thread only
 		std::vector<String> exceptions;
 		std::vector<size_t> playingSounds;
-		std::vector<size_t> playingSoundsNext;
 
 		std::map<int, AudioHandle> musicTracks;
 
@@ -77,6 +78,9 @@ namespace Halley {
 	    void run();
 	    void stepAudio();
 	    void enqueue(std::function<void()> action);
+	    void enqueue(AudioCommand command);
+		void runCommand(AudioCommand& command);
+		void discardCommands();
 		
 		void stopMusic(AudioHandle& handle, float fade);
 
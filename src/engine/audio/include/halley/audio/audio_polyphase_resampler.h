@@ -0,0 +1,40 @@
+#pragma once
+#include <gsl/span>
+#include <vector>
+
+namespace Halley
+{
+	enum class AudioResamplerQuality
+	{
+		Fast,
+		Normal,
+		High
+	};
+
+	// Windowed-sinc polyphase resampler for a single channel.
+	// Filter tables are built once per quality and shared by every instance, so construction is cheap,
+	// and the ratio can be changed between calls (e.g. for pitch modulation) without reinitialising.
+	class AudioPolyphaseResampler
+	{
+	public:
+		explicit AudioPolyphaseResampler(float ratio = 1.0f, AudioResamplerQuality quality = AudioResamplerQuality::Normal);
+
+		// Ratio is the number of input samples consumed per output sample (i.e. fromHz / toHz)
+		void setRatio(float ratio);
+		float getRatio() const;
+
+		size_t getInputSamplesNeeded(size_t numOutputSamples) const;
+
+		// Consumes all of src, and returns the number of samples written to dst. Input that can't be used yet is kept for the next call.
+		size_t resample(gsl::span<const float> src, gsl::span<float> dst);
+
+	private:
+		struct FilterBank;
+
+		AudioResamplerQuality quality;
+		const FilterBank* bank = nullptr;
+		double ratio = 1.0;
+		double pos = 0;
+		std::vector<float> history;
+	};
+}
@@ -31,6 +31,8 @@ namespace Halley
 		void setMix(size_t srcChannels, gsl::span<const AudioChannelData> dstChannels, gsl::span<float, 16> dst, float gain, const AudioListenerData& listener) const;
 		void setPosition(Vector3f position);
 
+		const SpatialSource* getSingleSpatialSource() const; // Returns nullptr unless this is positional with exactly one source
+
 	private:
 		std::vector<SpatialSource> sources;
 		float pan = 0;
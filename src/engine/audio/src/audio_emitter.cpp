@@ -3,6 +3,7 @@
 #include "audio_mixer.h"
 #include "audio_emitter_behaviour.h"
 #include "audio_source.h"
+#include "audio_spatialiser.h"
 #include "halley/support/logger.h"
 
 using namespace Halley;
@@ -101,7 +102,7 @@ size_t AudioEmitter::getNumberOfChannels() const
 	return nChannels;
 }
 
-void AudioEmitter::update(gsl::span<const AudioChannelData> channels, const AudioListenerData& listener, float groupGain)
+void AudioEmitter::update(gsl::span<const AudioChannelData> channels, const AudioListenerData& listener, float groupGain, AudioSpatialiser& spatialiser)
 {
 	Expects(playing);
 
@@ -114,7 +115,20 @@ void AudioEmitter::update(gsl::span<const AudioChannelData> channels, const Audi
 	}
 
 	prevChannelMix = channelMix;
-	sourcePos.setMix(nChannels, channels, channelMix, gain * groupGain, listener);
+	const float totalGain = gain * groupGain;
+
+	if (auto spatialSource = sourcePos.getSingleSpatialSource()) {
+		// Positional emitters are batched by the spatialiser, which calls back setSpatialisedMix. If nothing relevant changed, keep the old mix.
+		constexpr float threshold2 = AudioSpatialiser::positionThreshold * AudioSpatialiser::positionThreshold;
+		if (isFirstUpdate || spatialiser.isInvalidated() || totalGain != lastSpatialisedGain || (spatialSource->pos - lastSpatialisedPos).squaredLength() > threshold2) {
+			lastSpatialisedPos = spatialSource->pos;
+			lastSpatialisedGain = totalGain;
+			spatialiser.add(*this, *spatialSource, totalGain);
+		}
+		return;
+	}
+
+	sourcePos.setMix(nChannels, channels, channelMix, totalGain, listener);
 	
 	if (isFirstUpdate) {
 		prevChannelMix = channelMix;
@@ -122,6 +136,16 @@ void AudioEmitter::update(gsl::span<const AudioChannelData> channels, const Audi
 	}
 }
 
+void AudioEmitter::setSpatialisedMix(gsl::span<const float> mix)
+{
+	std::copy(mix.begin(), mix.end(), channelMix.begin());
+
+	if (isFirstUpdate) {
+		prevChannelMix = channelMix;
+		isFirstUpdate = false;
+	}
+}
+
 void AudioEmitter::mixTo(size_t numSamples, gsl::span<AudioBuffer*> dst, AudioMixer& mixer, AudioBufferPool& pool)
 {
 	Expects(dst.size() > 0);
@@ -9,6 +9,7 @@ namespace Halley {
 	class AudioMixer;
 	class AudioEmitterBehaviour;
 	class AudioSource;
+	class AudioSpatialiser;
 
 	class AudioEmitter {
     public:
@@ -29,7 +30,8 @@ namespace Halley {
 		float getGain() const;
 		size_t getNumberOfChannels() const;
 
-		void update(gsl::span<const AudioChannelData> channels, const AudioListenerData& listener, float groupGain);
+		void update(gsl::span<const AudioChannelData> channels, const AudioListenerData& listener, float groupGain, AudioSpatialiser& spatialiser);
+		void setSpatialisedMix(gsl::span<const float> mix);
 		void mixTo(size_t numSamples, gsl::span<AudioBuffer*> dst, AudioMixer& mixer, AudioBufferPool& pool);
 		
 		void setId(size_t id);
@@ -55,6 +57,9 @@ namespace Halley {
 		std::array<float, 16> channelMix;
 		std::array<float, 16> prevChannelMix;
 
+		Vector3f lastSpatialisedPos;
+		float lastSpatialisedGain = -1.0f;
+
 		size_t id = std::numeric_limits<size_t>::max();
 
 		void advancePlayback(size_t samples);
@@ -5,6 +5,7 @@
 #include "audio_source_clip.h"
 #include "audio_filter_resample.h"
 #include "halley/support/debug.h"
+#include "halley/support/memory_tracker.h"
 #include "halley/core/resources/resources.h"
 #include "audio_event.h"
 
@@ -16,7 +17,7 @@ AudioEngine::AudioEngine()
 	, running(true)
 	, needsBuffer(true)
 {
-	rng.setSeed(Random::getGlobal().getRawInt());
+	rng.setSeed(Random::getThreadLocal().getRawInt());
 }
 
 AudioEngine::~AudioEngine()
@@ -47,6 +48,7 @@ void AudioEngine::setOutputChannels(std::vector<AudioChannelData> channelData)
 
 void AudioEngine::run()
 {
+	MemoryTagScope memTag(MemoryTag::Audio);
 	//const size_t bufSize = spec.numChannels * sizeof(AudioConfig::SampleFormat) * spec.bufferSize;
 
 	// Generate one buffer
@@ -68,7 +70,12 @@ void AudioEngine::addEmitter(size_t id, std::unique_ptr<AudioEmitter>&& src)
 {
 	emitters.emplace_back(std::move(src));
 	emitters.back()->setId(id);
-	idToSource[id].push_back(emitters.back().get());
+
+	auto& sources = idToSource[id];
+	if (sources.empty()) {
+		notifications.emplace_back(AudioNotification::Type::SoundStarted, id);
+	}
+	sources.push_back(emitters.back().get());
 }
 
 const std::vector<AudioEmitter*>& AudioEngine::getSources(size_t id)
@@ -81,14 +88,10 @@ const std::vector<AudioEmitter*>& AudioEngine::getSources(size_t id)
 	}
 }
 
-std::vector<size_t> AudioEngine::getPlayingSounds()
+void AudioEngine::collectNotifications(std::vector<AudioNotification>& dst)
 {
-	std::vector<size_t> result(idToSource.size());
-	size_t i = 0;
-	for (const auto& kv: idToSource) {
-		result[i++] = kv.first;
-	}
-	return result;
+	dst.insert(dst.end(), notifications.begin(), notifications.end());
+	notifications.clear();
 }
 
 void AudioEngine::start(AudioSpec s, AudioOutputAPI& o)
@@ -173,19 +176,26 @@ void AudioEngine::mixEmitters(size_t numSamples, size_t nChannels, gsl::span<Aud
 		clearBuffer(buffers[i]->packs);
 	}
 
-	// Mix every emitter
+	// Update every emitter, queueing positional ones for spatialisation
+	playingEmitters.clear();
+	spatialiser.begin(channels, listener);
 	for (auto& e: emitters) {
 		// Start playing if necessary
 		if (!e->isPlaying() && !e->isDone() && e->isReady()) {
 			e->start();
 		}
 
-		// Mix it in!
 		if (e->isPlaying()) {
-			e->update(channels, listener, masterGain * getGroupGain(e->getGroup()));
-			e->mixTo(numSamples, buffers, *mixer, *pool);
+			e->update(channels, listener, masterGain * getGroupGain(e->getGroup()), spatialiser);
+			playingEmitters.push_back(e.get());
 		}
 	}
+	spatialiser.process();
+
+	// Mix them in!
+	for (auto& e: playingEmitters) {
+		e->mixTo(numSamples, buffers, *mixer, *pool);
+	}
 }
 
 void AudioEngine::removeFinishedEmitters()
@@ -199,6 +209,7 @@ void AudioEngine::removeFinishedEmitters()
 					ems.erase(std::remove_if(ems.begin(), ems.end(), [] (const AudioEmitter* e) { return e->isDone(); }), ems.end());
 				} else {
 					idToSource.erase(iter);
+					notifications.emplace_back(AudioNotification::Type::SoundFinished, e->getId());
 				}
 			}
 		}
@@ -6,9 +6,11 @@
 #include <map>
 #include <vector>
 #include "audio_emitter.h"
+#include "audio_spatialiser.h"
 #include "halley/audio/resampler.h"
 #include "halley/maths/random.h"
 #include "halley/data_structures/flat_map.h"
+#include "halley/audio/audio_command.h"
 
 namespace Halley {
 	class AudioMixer;
@@ -29,7 +31,7 @@ namespace Halley {
 		void addEmitter(size_t id, std::unique_ptr<AudioEmitter>&& src);
 
 		const std::vector<AudioEmitter*>& getSources(size_t id);
-		std::vector<size_t> getPlayingSounds();
+		void collectNotifications(std::vector<AudioNotification>& dst);
 
 		void run();
 		void start(AudioSpec spec, AudioOutputAPI& out);
@@ -62,12 +64,15 @@ namespace Halley {
 		
 		std::map<size_t, std::vector<AudioEmitter*>> idToSource;
 		std::vector<AudioEmitter*> dummyIdSource;
+		std::vector<AudioNotification> notifications;
 
 		float masterGain = 1.0f;
 		std::vector<String> groupNames;
     	std::vector<float> groupGains;
 
 		AudioListenerData listener;
+		AudioSpatialiser spatialiser;
+		std::vector<AudioEmitter*> playingEmitters;
 
 		Random rng;
 
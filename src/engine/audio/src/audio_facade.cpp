@@ -14,6 +14,8 @@ AudioFacade::AudioFacade(AudioOutputAPI& o, SystemAPI& system)
 	, system(system)
 	, running(false)
 	, started(false)
+	, commands(4096)
+	, notifications(4096)
 	, ownAudioThread(o.needsAudioThread())
 {
 }
@@ -87,6 +89,7 @@ void AudioFacade::stopPlayback()
 	if (started) {
 		pausePlayback();
 		musicTracks.clear();
+		discardCommands();
 		engine.reset();
 		output.closeAudioDevice();
 		started = false;
@@ -114,11 +117,8 @@ void AudioFacade::resumePlayback()
 void AudioFacade::pausePlayback()
 {
 	if (running) {
-		{
-			std::unique_lock<std::mutex> lock(audioMutex);
-			running = false;
-			engine->pause();
-		}
+		running = false;
+		engine->pause();
 		if (ownAudioThread) {
 			audioThread.join();
 			audioThread = {};
@@ -199,9 +199,7 @@ void AudioFacade::stopAllMusic(float fadeOutTime)
 
 void AudioFacade::setMasterVolume(float volume)
 {
-	enqueue([=] () {
-		engine->setMasterGain(volumeToGain(volume));
-	});
+	enqueue(AudioCommand(AudioCommand::Type::SetMasterGain, 0, {{ volumeToGain(volume), 0, 0, 0 }}));
 }
 
 void AudioFacade::setGroupVolume(const String& groupName, float volume)
@@ -237,9 +235,7 @@ void AudioFacade::onNeedBuffer()
 
 void AudioFacade::setListener(AudioListenerData listener)
 {
-	enqueue([=] () {
-		engine->setListener(listener);
-	});
+	enqueue(AudioCommand(AudioCommand::Type::SetListener, 0, {{ listener.position.x, listener.position.y, listener.position.z, listener.referenceDistance }}));
 }
 
 void AudioFacade::onAudioException(std::exception& e)
@@ -258,18 +254,13 @@ void AudioFacade::run()
 void AudioFacade::stepAudio()
 {
 	try {
-		{
-			std::unique_lock<std::mutex> lock(audioMutex);
-			if (!running) {
-				return;
-			}
-			std::swap(inbox, inboxProcessing);
-			inbox.clear();
-			playingSoundsNext = engine->getPlayingSounds();
+		if (!running) {
+			return;
 		}
 
-		for (auto& action : inboxProcessing) {
-			action();
+		AudioCommand command;
+		while (commands.tryPop(command)) {
+			runCommand(command);
 		}
 
 		if (ownAudioThread) {
@@ -277,16 +268,92 @@ void AudioFacade::stepAudio()
 		} else {
 			engine->generateBuffer();
 		}
+
+		// Send notifications back; anything that doesn't fit is retried next step
+		engine->collectNotifications(pendingNotifications);
+		size_t nSent = 0;
+		while (nSent < pendingNotifications.size() && notifications.tryPush(pendingNotifications[nSent])) {
+			++nSent;
+		}
+		pendingNotifications.erase(pendingNotifications.begin(), pendingNotifications.begin() + nSent);
 	} catch (std::exception& e) {
 		onAudioException(e);
 	}
 }
 
+void AudioFacade::runCommand(AudioCommand& command)
+{
+	using Type = AudioCommand::Type;
+	const auto& p = command.params;
+
+	switch (command.type) {
+	case Type::Action:
+		{
+			auto action = std::unique_ptr<std::function<void()>>(command.action);
+			command.action = nullptr;
+			(*action)();
+		}
+		break;
+	case Type::SetGain:
+		for (auto& src: engine->getSources(command.id)) {
+			src->setGain(p[0]);
+		}
+		break;
+	case Type::SetPosition:
+		for (auto& src: engine->getSources(command.id)) {
+			src->setAudioSourcePosition(Vector3f(p[0], p[1], p[2]));
+		}
+		break;
+	case Type::SetPan:
+		for (auto& src: engine->getSources(command.id)) {
+			src->setAudioSourcePosition(AudioPosition::makeUI(p[0]));
+		}
+		break;
+	case Type::Stop:
+		for (auto& src: engine->getSources(command.id)) {
+			src->stop();
+		}
+		break;
+	case Type::SetMasterGain:
+		engine->setMasterGain(p[0]);
+		break;
+	case Type::SetListener:
+		engine->setListener(AudioListenerData(Vector3f(p[0], p[1], p[2]), p[3]));
+		break;
+	}
+}
+
 void AudioFacade::enqueue(std::function<void()> action)
 {
 	if (running) {
-		outbox.emplace_back(std::move(action));
+		outbox.emplace_back(AudioCommand::Type::Action, 0, std::array<float, 4>(), new std::function<void()>(std::move(action)));
+	}
+}
+
+void AudioFacade::enqueue(AudioCommand command)
+{
+	if (running) {
+		outbox.push_back(command);
+	}
+}
+
+void AudioFacade::discardCommands()
+{
+	// Only safe when the audio thread isn't running
+	for (auto& c: outbox) {
+		delete c.action;
+	}
+	outbox.clear();
+
+	AudioCommand command;
+	while (commands.tryPop(command)) {
+		delete command.action;
 	}
+
+	AudioNotification notification;
+	while (notifications.tryPop(notification)) {}
+	pendingNotifications.clear();
+	playingSounds.clear();
 }
 
 void AudioFacade::pump()
@@ -305,19 +372,29 @@ void AudioFacade::pump()
 	}
 
 	if (running) {
-		std::unique_lock<std::mutex> lock(audioMutex);
-		if (!outbox.empty()) {
-			size_t i = inbox.size();
-			inbox.resize(i + outbox.size());
-			for (auto& o: outbox) {
-				inbox[i++] = std::move(o);
+		// Hand over as many commands as the queue will take; the rest wait for the next pump, in order
+		size_t nSent = 0;
+		while (nSent < outbox.size() && commands.tryPush(outbox[nSent])) {
+			++nSent;
+		}
+		outbox.erase(outbox.begin(), outbox.begin() + nSent);
+
+		AudioNotification notification;
+		while (notifications.tryPop(notification)) {
+			const auto iter = std::lower_bound(playingSounds.begin(), playingSounds.end(), notification.id);
+			const bool present = iter != playingSounds.end() && *iter == notification.id;
+			if (notification.type == AudioNotification::Type::SoundStarted) {
+				if (!present) {
+					playingSounds.insert(iter, notification.id);
+				}
+			} else if (present) {
+				playingSounds.erase(iter);
 			}
-			outbox.clear();
 		}
-
-		playingSounds = playingSoundsNext;
 	} else {
-		inbox.clear();
+		for (auto& c: outbox) {
+			delete c.action;
+		}
 		outbox.clear();
 	}
 }
@@ -1,6 +1,6 @@
 #pragma once
 #include "audio_source.h"
-#include "halley/audio/resampler.h"
+#include "audio_polyphase_resampler.h"
 #include "audio_buffer.h"
 
 namespace Halley
@@ -17,15 +17,8 @@ namespace Halley
 	private:
 		AudioBufferPool& pool;
 		std::shared_ptr<AudioSource> source;
-		std::vector<std::unique_ptr<AudioResampler>> resamplers;
-		int fromHz;
-		int toHz;
-
-		struct LeftOverData
-		{
-			std::array<AudioConfig::SampleFormat, 8> samples;
-			size_t n = 0;
-		};
-		std::array<LeftOverData, AudioConfig::maxChannels> leftoverSamples;
+		std::vector<AudioPolyphaseResampler> resamplers;
+		const int fromHz;
+		const int toHz;
 	};
 }
@@ -13,10 +13,7 @@ AudioHandleImpl::AudioHandleImpl(AudioFacade& facade, size_t id)
 
 void AudioHandleImpl::setGain(float gain)
 {
-	enqueue([gain] (AudioEmitter& src)
-	{
-		src.setGain(gain);
-	});
+	facade.enqueue(AudioCommand(AudioCommand::Type::SetGain, handleId, {{ gain, 0, 0, 0 }}));
 }
 
 void AudioHandleImpl::setVolume(float volume)
@@ -26,30 +23,24 @@ void AudioHandleImpl::setVolume(float volume)
 
 void AudioHandleImpl::setPosition(Vector2f pos)
 {
-	enqueue([pos] (AudioEmitter& src)
-	{
-		src.setAudioSourcePosition(Vector3f(pos));
-	});
+	facade.enqueue(AudioCommand(AudioCommand::Type::SetPosition, handleId, {{ pos.x, pos.y, 0, 0 }}));
 }
 
 void AudioHandleImpl::setPan(float pan)
 {
-	enqueue([pan] (AudioEmitter& src)
-	{
-		src.setAudioSourcePosition(AudioPosition::makeUI(pan));
-	});
+	facade.enqueue(AudioCommand(AudioCommand::Type::SetPan, handleId, {{ pan, 0, 0, 0 }}));
 }
 
 void AudioHandleImpl::stop(float fadeTime)
 {
-	enqueue([fadeTime] (AudioEmitter& src)
-	{
-		if (fadeTime >= 0.001f) {
+	if (fadeTime >= 0.001f) {
+		enqueue([fadeTime] (AudioEmitter& src)
+		{
 			src.setBehaviour(std::make_unique<AudioEmitterFadeBehaviour>(fadeTime, 0.0f, true));
-		} else {
-			src.stop();
-		}
-	});
+		});
+	} else {
+		facade.enqueue(AudioCommand(AudioCommand::Type::Stop, handleId));
+	}
 }
 
 void AudioHandleImpl::setBehaviour(std::unique_ptr<AudioEmitterBehaviour> b)
@@ -0,0 +1,181 @@
+#include "audio_polyphase_resampler.h"
+#include "audio_mixer.h"
+#include "halley/utils/utils.h"
+#include <array>
+#include <cmath>
+
+#ifdef HAS_SSE
+#include <xmmintrin.h>
+#endif
+
+using namespace Halley;
+
+namespace {
+	constexpr size_t numPhases = 128;
+
+	// Upper bounds of the ratio for each bank. Downsampling (ratio > 1) needs the cutoff lowered to avoid aliasing.
+	constexpr std::array<float, 4> bankRatios = {{ 1.0f, 1.25f, 1.5f, 2.0f }};
+
+	size_t getNumTaps(AudioResamplerQuality quality)
+	{
+		switch (quality) {
+		case AudioResamplerQuality::Fast:
+			return 8;
+		case AudioResamplerQuality::High:
+			return 32;
+		default:
+			return 16;
+		}
+	}
+
+	float dot(const float* src, const float* coefs, size_t n)
+	{
+#ifdef HAS_SSE
+		__m128 acc0 = _mm_setzero_ps();
+		__m128 acc1 = _mm_setzero_ps();
+		for (size_t i = 0; i < n; i += 8) {
+			acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(src + i), _mm_loadu_ps(coefs + i)));
+			acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(src + i + 4), _mm_loadu_ps(coefs + i + 4)));
+		}
+		alignas(16) float result[4];
+		_mm_store_ps(result, _mm_add_ps(acc0, acc1));
+		return result[0] + result[1] + result[2] + result[3];
+#else
+		float acc = 0;
+		for (size_t i = 0; i < n; ++i) {
+			acc += src[i] * coefs[i];
+		}
+		return acc;
+#endif
+	}
+}
+
+struct AudioPolyphaseResampler::FilterBank
+{
+	size_t numTaps;
+	std::vector<float> coefs; // (numPhases + 1) rows of numTaps, so the last phase can be interpolated against
+
+	FilterBank(size_t numTaps, float maxRatio)
+		: numTaps(numTaps)
+		, coefs((numPhases + 1) * numTaps)
+	{
+		const double pi = 3.14159265358979323846;
+		const double cutoff = 0.95 / maxRatio;
+		const double halfWidth = double(numTaps / 2);
+
+		for (size_t phase = 0; phase <= numPhases; ++phase) {
+			const double frac = double(phase) / double(numPhases);
+			float* row = coefs.data() + phase * numTaps;
+
+			double sum = 0;
+			for (size_t k = 0; k < numTaps; ++k) {
+				const double x = double(k) - (halfWidth - 1) - frac;
+				const double sinc = std::abs(x) < 1e-9 ? 1.0 : std::sin(pi * cutoff * x) / (pi * cutoff * x);
+				const double w = x / halfWidth;
+				const double window = std::abs(w) >= 1.0 ? 0.0 : 0.42 + 0.5 * std::cos(pi * w) + 0.08 * std::cos(2 * pi * w); // Blackman
+				row[k] = float(sinc * window);
+				sum += row[k];
+			}
+
+			// Normalise for unity gain at DC
+			for (size_t k = 0; k < numTaps; ++k) {
+				row[k] = float(row[k] / sum);
+			}
+		}
+	}
+
+	static const FilterBank& get(AudioResamplerQuality quality, double ratio)
+	{
+		size_t bankIdx = 0;
+		while (bankIdx < bankRatios.size() - 1 && ratio > bankRatios[bankIdx]) {
+			++bankIdx;
+		}
+
+		const auto makeBanks = [] (AudioResamplerQuality q)
+		{
+			std::vector<FilterBank> banks;
+			for (auto r: bankRatios) {
+				banks.emplace_back(getNumTaps(q), r);
+			}
+			return banks;
+		};
+		static const std::array<std::vector<FilterBank>, 3> banks = {{
+			makeBanks(AudioResamplerQuality::Fast),
+			makeBanks(AudioResamplerQuality::Normal),
+			makeBanks(AudioResamplerQuality::High)
+		}};
+
+		return banks[int(quality)][bankIdx];
+	}
+};
+
+AudioPolyphaseResampler::AudioPolyphaseResampler(float ratio, AudioResamplerQuality quality)
+	: quality(quality)
+{
+	setRatio(ratio);
+
+	// Prime with silence so the first output sample is centred on the first input sample
+	const size_t half = bank->numTaps / 2;
+	history.resize(half - 1, 0.0f);
+	pos = double(half - 1);
+}
+
+void AudioPolyphaseResampler::setRatio(float r)
+{
+	ratio = clamp(double(r), 0.01, double(bankRatios.back()));
+	bank = &FilterBank::get(quality, ratio);
+}
+
+float AudioPolyphaseResampler::getRatio() const
+{
+	return float(ratio);
+}
+
+size_t AudioPolyphaseResampler::getInputSamplesNeeded(size_t numOutputSamples) const
+{
+	if (numOutputSamples == 0) {
+		return 0;
+	}
+
+	// One extra sample of margin in case of rounding differences against the accumulated position; it's simply kept in history
+	const double lastPos = pos + double(numOutputSamples - 1) * ratio;
+	const size_t needed = size_t(lastPos) + bank->numTaps / 2 + 2;
+	return needed > history.size() ? needed - history.size() : 0;
+}
+
+size_t AudioPolyphaseResampler::resample(gsl::span<const float> src, gsl::span<float> dst)
+{
+	history.insert(history.end(), src.begin(), src.end());
+
+	const size_t numTaps = bank->numTaps;
+	const size_t half = numTaps / 2;
+	const float* coefs = bank->coefs.data();
+	const size_t historySize = history.size();
+	const size_t dstSize = size_t(dst.size());
+
+	size_t written = 0;
+	while (written < dstSize) {
+		const size_t n0 = size_t(pos);
+		if (n0 + half >= historySize) {
+			break;
+		}
+
+		const double phasePos = (pos - double(n0)) * double(numPhases);
+		const size_t phase = size_t(phasePos);
+		const float t = float(phasePos - double(phase));
+
+		const float* x = history.data() + (n0 + 1 - half);
+		const float a = dot(x, coefs + phase * numTaps, numTaps);
+		const float b = dot(x, coefs + (phase + 1) * numTaps, numTaps);
+		dst[written++] = a + (b - a) * t;
+
+		pos += ratio;
+	}
+
+	// Drop samples that are no longer in any future filter window
+	const size_t consumed = std::min(size_t(pos) + 1 - half, historySize);
+	history.erase(history.begin(), history.begin() + consumed);
+	pos -= double(consumed);
+
+	return written;
+}
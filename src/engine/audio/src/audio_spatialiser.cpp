@@ -0,0 +1,146 @@
+#include "audio_spatialiser.h"
+#include "audio_emitter.h"
+#include "audio_mixer.h"
+
+#ifdef HAS_SSE
+#include <xmmintrin.h>
+#endif
+
+using namespace Halley;
+
+// sin(x * pi / 2) for x in [0, 1], via its Taylor series (error below 1e-5), so it can be vectorised
+static inline float sinHalfPi(float x)
+{
+	const float x2 = x * x;
+	return x * (1.5707963f - x2 * (0.6459641f - x2 * (0.0796926f - x2 * (0.0046817f - x2 * 0.0001604f))));
+}
+
+#ifdef HAS_SSE
+static inline __m128 sinHalfPi(__m128 x)
+{
+	const __m128 x2 = _mm_mul_ps(x, x);
+	__m128 r = _mm_sub_ps(_mm_set1_ps(0.0046817f), _mm_mul_ps(x2, _mm_set1_ps(0.0001604f)));
+	r = _mm_sub_ps(_mm_set1_ps(0.0796926f), _mm_mul_ps(x2, r));
+	r = _mm_sub_ps(_mm_set1_ps(0.6459641f), _mm_mul_ps(x2, r));
+	r = _mm_sub_ps(_mm_set1_ps(1.5707963f), _mm_mul_ps(x2, r));
+	return _mm_mul_ps(x, r);
+}
+#endif
+
+void AudioSpatialiser::begin(gsl::span<const AudioChannelData> newChannels, const AudioListenerData& newListener)
+{
+	emitters.clear();
+	posX.clear();
+	posY.clear();
+	posZ.clear();
+	referenceDistance.clear();
+	invDistanceRange.clear();
+	gain.clear();
+
+	bool channelsChanged = size_t(newChannels.size()) != channels.size();
+	for (size_t i = 0; i < channels.size() && !channelsChanged; ++i) {
+		channelsChanged = channels[i].pan != newChannels[i].pan || channels[i].gain != newChannels[i].gain;
+	}
+	const bool listenerChanged = (listener.position - newListener.position).squaredLength() > positionThreshold * positionThreshold || listener.referenceDistance != newListener.referenceDistance;
+
+	invalidated = channelsChanged || listenerChanged;
+	if (channelsChanged) {
+		channels.assign(newChannels.begin(), newChannels.end());
+	}
+	if (listenerChanged) {
+		listener = newListener;
+	}
+}
+
+bool AudioSpatialiser::isInvalidated() const
+{
+	return invalidated;
+}
+
+void AudioSpatialiser::add(AudioEmitter& emitter, const AudioPosition::SpatialSource& source, float g)
+{
+	emitters.push_back(&emitter);
+	posX.push_back(source.pos.x);
+	posY.push_back(source.pos.y);
+	posZ.push_back(source.pos.z);
+	referenceDistance.push_back(source.referenceDistance);
+	invDistanceRange.push_back(1.0f / (source.maxDistance - source.referenceDistance));
+	gain.push_back(g);
+}
+
+void AudioSpatialiser::process()
+{
+	const size_t n = emitters.size();
+	if (n == 0) {
+		return;
+	}
+
+	// Pad to a whole number of SIMD lanes; padding has zero gain
+	const size_t stride = alignUp(n, size_t(4));
+	posX.resize(stride, 0.0f);
+	posY.resize(stride, 0.0f);
+	posZ.resize(stride, 0.0f);
+	referenceDistance.resize(stride, 1.0f);
+	invDistanceRange.resize(stride, 1.0f);
+	gain.resize(stride, 0.0f);
+	result.resize(stride * channels.size());
+
+	computeGains(stride);
+
+	const size_t nChannels = channels.size();
+	std::array<float, 16> mix;
+	for (size_t i = 0; i < n; ++i) {
+		for (size_t j = 0; j < nChannels; ++j) {
+			mix[j] = result[j * stride + i];
+		}
+		emitters[i]->setSpatialisedMix(gsl::span<const float>(mix.data(), nChannels));
+	}
+}
+
+void AudioSpatialiser::computeGains(size_t stride)
+{
+	const size_t nChannels = channels.size();
+	const float invListenerRef = 1.0f / listener.referenceDistance;
+
+#ifdef HAS_SSE
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 minusOne = _mm_set1_ps(-1.0f);
+	const __m128 half = _mm_set1_ps(0.5f);
+	const __m128 signMask = _mm_set1_ps(-0.0f);
+	const __m128 lx = _mm_set1_ps(listener.position.x);
+	const __m128 ly = _mm_set1_ps(listener.position.y);
+	const __m128 lz = _mm_set1_ps(listener.position.z);
+	const __m128 invRef = _mm_set1_ps(invListenerRef);
+
+	for (size_t i = 0; i < stride; i += 4) {
+		const __m128 dx = _mm_sub_ps(_mm_loadu_ps(&posX[i]), lx);
+		const __m128 dy = _mm_sub_ps(_mm_loadu_ps(&posY[i]), ly);
+		const __m128 dz = _mm_sub_ps(_mm_loadu_ps(&posZ[i]), lz);
+		const __m128 dist = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz)));
+
+		const __m128 pan = _mm_max_ps(minusOne, _mm_min_ps(one, _mm_mul_ps(dx, invRef)));
+		const __m128 attenuation = _mm_max_ps(zero, _mm_min_ps(one, _mm_mul_ps(_mm_sub_ps(dist, _mm_loadu_ps(&referenceDistance[i])), _mm_loadu_ps(&invDistanceRange[i]))));
+		const __m128 g = _mm_mul_ps(_mm_loadu_ps(&gain[i]), _mm_sub_ps(one, attenuation));
+
+		for (size_t j = 0; j < nChannels; ++j) {
+			const __m128 panDistance = _mm_andnot_ps(signMask, _mm_sub_ps(pan, _mm_set1_ps(channels[j].pan)));
+			const __m128 t = _mm_max_ps(zero, _mm_sub_ps(one, _mm_mul_ps(half, panDistance)));
+			const __m128 channelGain = _mm_mul_ps(sinHalfPi(t), _mm_mul_ps(g, _mm_set1_ps(channels[j].gain)));
+			_mm_storeu_ps(&result[j * stride + i], channelGain);
+		}
+	}
+#else
+	for (size_t i = 0; i < stride; ++i) {
+		const Vector3f delta = Vector3f(posX[i], posY[i], posZ[i]) - listener.position;
+		const float pan = clamp(delta.x * invListenerRef, -1.0f, 1.0f);
+		const float attenuation = clamp((delta.length() - referenceDistance[i]) * invDistanceRange[i], 0.0f, 1.0f);
+		const float g = gain[i] * (1.0f - attenuation);
+
+		for (size_t j = 0; j < nChannels; ++j) {
+			const float t = std::max(0.0f, 1.0f - 0.5f * std::abs(pan - channels[j].pan));
+			result[j * stride + i] = sinHalfPi(t) * g * channels[j].gain;
+		}
+	}
+#endif
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <gsl/span>
+#include <array>
+#include <vector>
+#include "halley/core/api/audio_api.h"
+#include "audio_position.h"
+
+namespace Halley
+{
+	class AudioEmitter;
+
+	// Computes channel gains for all single-source positional emitters in one pass, in SoA form.
+	// Emitters are only queued here when they've moved beyond positionThreshold or changed gain,
+	// or when the listener or output channels have changed.
+	class AudioSpatialiser
+	{
+	public:
+		constexpr static float positionThreshold = 1.0f;
+
+		void begin(gsl::span<const AudioChannelData> channels, const AudioListenerData& listener);
+		bool isInvalidated() const;
+
+		void add(AudioEmitter& emitter, const AudioPosition::SpatialSource& source, float gain);
+		void process();
+
+	private:
+		std::vector<AudioChannelData> channels;
+		AudioListenerData listener;
+		bool invalidated = true;
+
+		std::vector<AudioEmitter*> emitters;
+		std::vector<float> posX;
+		std::vector<float> posY;
+		std::vector<float> posZ;
+		std::vector<float> referenceDistance;
+		std::vector<float> invDistanceRange;
+		std::vector<float> gain;
+		std::vector<float> result;
+
+		void computeGains(size_t stride);
+	};
+}
@@ -3,6 +3,7 @@
 #include <array>
 #include <halley/utils/utils.h>
 #include <halley/text/string_converter.h>
+#include <halley/concurrency/future.h>
 #include <limits>
 
 #ifdef max
@@ -39,8 +40,23 @@ namespace Halley {
 		virtual void removeData(const String& path) {};
 		virtual std::vector<String> enumerate(const String& root) = 0;
 
+		// With commit set, the data is in storage when this returns; otherwise it may be held until commit() is called
 		virtual void setData(const String& path, const Bytes& data, bool commit = true) = 0;
 		virtual void commit() = 0;
+
+		// Queues a write and returns immediately. The future resolves to whether the data made it to storage.
+		// Implementations may coalesce repeated writes to the same path; only the latest data is guaranteed to be written.
+		virtual Future<bool> setDataAsync(const String& path, Bytes data)
+		{
+			setData(path, data, true);
+			Promise<bool> promise;
+			promise.setValue(true);
+			return promise.getFuture();
+		}
+
+		// Blocks until all queued writes have been flushed to storage
+		virtual void waitForPendingWrites() {}
+
 		virtual size_t getFreeSpace() { return std::numeric_limits<size_t>::max(); }
 	};
 }
@@ -12,6 +12,7 @@
 #include "halley_statics.h"
 #include <halley/data_structures/tree_map.h>
 #include "halley/support/logger.h"
+#include "halley/support/stats.h"
 
 namespace Halley
 {
@@ -75,10 +76,20 @@ namespace Halley
 		void pumpEvents(Time time);
 		void pumpAudio();
 
+		void initStats();
+		void sampleStats();
+		void dumpStats() const;
+
 		std::array<StopwatchAveraging, int(TimeLine::NUMBER_OF_TIMELINES)> engineTimers;
 		std::array<StopwatchAveraging, int(TimeLine::NUMBER_OF_TIMELINES)> gameTimers;
 		StopwatchAveraging vsyncTimer;
 
+		std::array<StatHandle, int(TimeLine::NUMBER_OF_TIMELINES)> frameTimeStats;
+		StatHandle vsyncTimeStat;
+		StatHandle drawCallsStat;
+		StatHandle verticesStat;
+		String statsDumpPath;
+
 		Vector<String> args;
 
 		std::unique_ptr<Environment> environment;
@@ -53,6 +53,7 @@ namespace Halley {
 
 		Vector2f screenToWorld(Vector2f p, Rect4f viewport) const;
 		Vector2f worldToScreen(Vector2f p, Rect4f viewport) const;
+		Matrix4f getWorldToScreen(Rect4f viewport) const; // Same as worldToScreen, for batches via Matrix4f::transformPoints
 
 		Matrix4f getProjection() const { return projection; }
 
@@ -97,6 +97,9 @@ namespace Halley
 		void onAudioFrameAvailable(Time time, gsl::span<const short> samples);
 		void onAudioFrameAvailable(Time time, gsl::span<const float> samples);
 
+		// Returns a buffer for decoded frame data, reusing the memory of frames that have already been uploaded
+		Bytes getFrameBuffer(size_t size);
+
 		std::shared_ptr<MoviePlayerAliveFlag> getAliveFlag() const;
 
 		std::vector<MoviePlayerStream> streams;
@@ -113,6 +116,7 @@ namespace Halley
 
 		Vector2i videoSize;
 		std::shared_ptr<Texture> currentTexture;
+		std::shared_ptr<Texture> lastConvertedTexture;
 		std::shared_ptr<TextureRenderTarget> renderTarget;
 		std::shared_ptr<Texture> renderTexture;
 
@@ -123,6 +127,8 @@ namespace Halley
 		std::atomic<bool> threadAborted;
 		std::thread workerThread;
 		std::shared_ptr<MoviePlayerAliveFlag> aliveFlag;
+		std::vector<Bytes> frameBufferPool; // Guarded by aliveFlag's mutex
+		std::vector<float> audioConversionBuffer;
 
 		Time time = 0;
 
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+#include <initializer_list>
+#include "halley/maths/vector2.h"
+#include "halley/maths/colour.h"
+#include "halley/maths/range.h"
+#include "halley/maths/angle.h"
+#include "halley/maths/random.h"
+#include "halley/time/halleytime.h"
+#include "halley/core/graphics/sprite/sprite.h"
+
+namespace Halley {
+	class Painter;
+
+	// A value over a particle's normalised lifetime [0, 1], baked into a lookup table
+	class ParticleCurve {
+	public:
+		ParticleCurve(float constant = 1.0f);
+		ParticleCurve(std::initializer_list<std::pair<float, float>> keyframes); // (time, value), sorted by time
+
+		float evaluate(float t) const;
+
+	private:
+		constexpr static size_t resolution = 32;
+		std::array<float, resolution + 1> samples;
+	};
+
+	struct ParticleEmitterConfig {
+		float spawnRate = 100.0f; // Particles per second
+		size_t maxParticles = 1000;
+
+		Range<float> lifetime = Range<float>(1.0f, 1.0f); // Seconds
+		Range<float> speed = Range<float>(0.0f, 100.0f);
+		Angle1f direction;
+		Angle1f directionScatter = Angle1f::fromDegrees(180.0f);
+		Vector2f spawnArea; // Half extents of the box around the emitter position
+
+		Vector2f acceleration;
+		float drag = 0.0f; // Fraction of velocity lost per second
+
+		Range<float> startScale = Range<float>(1.0f, 1.0f);
+		Range<float> rotationSpeed; // Radians per second
+
+		Colour4f startColour = Colour4f(1, 1, 1, 1);
+		Colour4f endColour = Colour4f(1, 1, 1, 1);
+		ParticleCurve colourCurve = ParticleCurve({ { 0.0f, 0.0f }, { 1.0f, 1.0f } }); // Blend from start to end colour
+		ParticleCurve alphaCurve;
+		ParticleCurve scaleCurve;
+	};
+
+	// Particles are stored as structure of arrays, so they can be integrated four at a time
+	class ParticleEmitter {
+	public:
+		ParticleEmitter(ParticleEmitterConfig config, Sprite sprite);
+
+		void setPosition(Vector2f position);
+		Vector2f getPosition() const;
+
+		void setEnabled(bool enabled);
+		bool isEnabled() const;
+
+		void burst(size_t n);
+		void clear();
+		size_t getNumParticles() const;
+		bool isIdle() const;
+
+		const ParticleEmitterConfig& getConfig() const;
+		ParticleEmitterConfig& getConfig();
+
+		void update(Time t);
+		void draw(Painter& painter) const;
+
+	private:
+		ParticleEmitterConfig config;
+		Sprite sprite;
+		Random rng;
+
+		Vector2f position;
+		bool enabled = true;
+		float pendingSpawn = 0;
+		size_t count = 0;
+
+		std::vector<float> posX;
+		std::vector<float> posY;
+		std::vector<float> velX;
+		std::vector<float> velY;
+		std::vector<float> age; // Normalised, particle dies at 1
+		std::vector<float> ageRate;
+		std::vector<float> rotation;
+		std::vector<float> rotationSpeed;
+		std::vector<float> scale;
+
+		mutable std::vector<SpriteVertexAttrib> vertices;
+
+		void reserve(size_t n);
+		void spawn(size_t n);
+		void integrate(float dt);
+		void removeDead();
+	};
+
+	class ParticleSystem {
+	public:
+		ParticleEmitter& addEmitter(ParticleEmitterConfig config, Sprite sprite);
+		void removeEmitter(const ParticleEmitter& emitter);
+		void removeIdleEmitters();
+		void clear();
+
+		size_t getNumEmitters() const;
+		size_t getNumParticles() const;
+
+		// Emitters are independent, so with parallel set they are updated across the default execution queue
+		void update(Time t, bool parallel = true);
+		void draw(Painter& painter) const;
+
+	private:
+		std::vector<std::unique_ptr<ParticleEmitter>> emitters;
+	};
+}
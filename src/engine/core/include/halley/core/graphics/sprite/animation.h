@@ -21,6 +21,7 @@ namespace Halley
 	{
 	public:
 		AnimationFrame(int frameNumber, int duration, const String& imageName, const SpriteSheet& sheet, const Vector<AnimationDirection>& directions);
+		AnimationFrame(int duration, Vector<const SpriteSheetEntry*> sprites);
 
 		const SpriteSheetEntry& getSprite(int dir) const
 		{
@@ -41,6 +42,9 @@ namespace Halley
 		AnimationFrameDefinition(int frameNumber, int duration, String imageName);
 		AnimationFrame makeFrame(const SpriteSheet& sheet, const Vector<AnimationDirection>& directions) const;
 
+		// Stores the hash of the sprite name for each direction, so makeFrame doesn't have to build and look up the names
+		void hashSpriteNames(const Vector<AnimationDirection>& directions);
+
 		void serialize(Serializer& s) const;
 		void deserialize(Deserializer& s);
 
@@ -48,6 +52,9 @@ namespace Halley
 		String imageName;
 		int frameNumber;
 		int duration;
+		Vector<uint64_t> spriteNameHashes;
+
+		String getSpriteName(const AnimationDirection& direction) const;
 	};
 
 	class AnimationSequence
@@ -48,6 +48,7 @@ namespace Halley
 		Sprite& setMaterial(Resources& resources, String materialName = "");
 		Sprite& setMaterial(std::shared_ptr<Material> m);
 		Material& getMaterial() const { return *material; }
+		const std::shared_ptr<Material>& getMaterialPtr() const { return material; }
 		bool hasMaterial() const { return material != nullptr; }
 
 		Sprite& setImage(Resources& resources, String imageName, String materialName = "");
@@ -108,6 +109,8 @@ namespace Halley
 
 		Sprite clone() const;
 
+		const SpriteVertexAttrib& getVertexAttrib() const { return vertexAttrib; }
+
 	private:
 		std::shared_ptr<Material> material;
 		SpriteVertexAttrib vertexAttrib;
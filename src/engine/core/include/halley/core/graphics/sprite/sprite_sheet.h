@@ -6,6 +6,7 @@
 #include <halley/resources/resource.h>
 #include <halley/text/halleystring.h>
 #include <halley/data_structures/hash_map.h>
+#include <halley/data_structures/maybe.h>
 #include <gsl/span>
 #include "halley/maths/vector4.h"
 
@@ -60,6 +61,14 @@ namespace Halley
 		size_t getIndex(const String& name) const;
 		bool hasSprite(const String& name) const;
 
+		// Names are hashed when the sheet is imported, so lookups by hash skip string comparisons entirely.
+		// Indices are stable for the lifetime of the sheet, so resolve once and keep them (they may change if the sheet is reloaded).
+		static uint64_t getNameHash(const String& name);
+		Maybe<size_t> tryGetIndex(uint64_t nameHash) const;
+
+		// Resolves many sprites at once (e.g. every frame of an animation), returns false if any of them is missing
+		bool tryGetSprites(gsl::span<const uint64_t> nameHashes, gsl::span<const SpriteSheetEntry*> result) const;
+
 		void loadJson(gsl::span<const gsl::byte> data);
 
 		void addSprite(String name, const SpriteSheetEntry& sprite);
@@ -78,6 +87,8 @@ namespace Halley
 		mutable std::shared_ptr<const Texture> texture;
 		std::vector<SpriteSheetEntry> sprites;
 		HashMap<String, uint32_t> spriteIdx;
+		std::vector<uint64_t> nameHashes; // Sorted
+		std::vector<uint32_t> nameHashIndices;
 		std::vector<SpriteSheetFrameTag> frameTags;
 		String textureName;
 
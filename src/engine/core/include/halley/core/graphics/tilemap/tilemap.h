@@ -0,0 +1,101 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "halley/maths/vector2.h"
+#include "halley/maths/rect.h"
+#include "halley/core/graphics/sprite/sprite.h"
+
+namespace Halley {
+	class Painter;
+	class Material;
+	class Serializer;
+	class Deserializer;
+
+	using TileId = uint16_t;
+	constexpr static TileId emptyTile = 0xFFFF;
+
+	// Maps tile ids to regions of a single material's texture
+	class TileSet {
+	public:
+		TileSet();
+		TileSet(std::shared_ptr<Material> material, Vector2f tileSize);
+
+		// Adds tiles for a texture laid out as a regular grid, left to right and top to bottom
+		static TileSet fromGrid(std::shared_ptr<Material> material, Vector2f tileSize, Vector2i gridSize);
+
+		TileId addTile(Rect4f texRect);
+		Rect4f getTexRect(TileId id) const;
+		size_t getNumTiles() const;
+
+		const std::shared_ptr<Material>& getMaterial() const;
+		Vector2f getTileSize() const;
+
+	private:
+		std::shared_ptr<Material> material;
+		Vector2f tileSize;
+		std::vector<Rect4f> texRects;
+	};
+
+	// Grid of tile ids, split into square chunks. Each chunk has a revision, bumped whenever one of its tiles changes,
+	// so renderers can tell which cached geometry is stale.
+	class TileMap {
+	public:
+		TileMap();
+		TileMap(Vector2i size, int chunkSize = 32);
+
+		Vector2i getSize() const;
+		int getChunkSize() const;
+		Vector2i getNumChunks() const;
+
+		TileId getTile(Vector2i pos) const;
+		void setTile(Vector2i pos, TileId tile);
+		void fill(Rect4i area, TileId tile);
+
+		uint32_t getChunkRevision(Vector2i chunk) const;
+
+		void serialize(Serializer& s) const;
+		void deserialize(Deserializer& s);
+
+	private:
+		Vector2i size;
+		int chunkSize = 32;
+		Vector2i numChunks;
+		std::vector<TileId> tiles;
+		std::vector<uint32_t> chunkRevisions;
+
+		void resetChunks();
+		size_t getChunkIndex(Vector2i chunk) const;
+	};
+
+	// Draws a TileMap by caching the vertex data of each chunk, rebuilding only chunks whose tiles changed,
+	// and submitting only chunks that overlap the view
+	class TileMapRenderer {
+	public:
+		TileMapRenderer(std::shared_ptr<const TileMap> map, TileSet tileSet);
+
+		void setPosition(Vector2f position);
+		Vector2f getPosition() const;
+
+		void setColour(Colour4f colour);
+
+		void draw(Painter& painter) const;
+		void draw(Painter& painter, Rect4f view) const;
+		void invalidate();
+
+	private:
+		struct Chunk {
+			std::vector<SpriteVertexAttrib> vertices;
+			uint32_t revision = 0;
+			bool built = false;
+		};
+
+		std::shared_ptr<const TileMap> map;
+		TileSet tileSet;
+		Vector2f position;
+		Colour4f colour = Colour4f(1, 1, 1, 1);
+		mutable std::vector<Chunk> chunks;
+
+		void buildChunk(Vector2i chunkPos, Chunk& chunk) const;
+	};
+}
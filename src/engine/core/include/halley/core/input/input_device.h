@@ -76,6 +76,15 @@ namespace Halley {
 
 		virtual void setParent(InputDevice* parent);
 		virtual InputDevice* getParent() const;
+
+		// Changes whenever button or axis state changes, so anything caching it (e.g. InputVirtual) knows when to read it again
+		virtual uint32_t getStateVersion() const;
+
+	protected:
+		void notifyStateChanged() { ++stateVersion; }
+
+	private:
+		uint32_t stateVersion = 0;
 	};
 	
 }
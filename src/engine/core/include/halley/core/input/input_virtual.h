@@ -24,11 +24,13 @@
 #include "input_button_base.h"
 #include "halley/maths/rect.h"
 #include "halley/data_structures/maybe.h"
-#include <set>
 
 namespace Halley {
 	using spInputDevice = std::shared_ptr<InputDevice>;
 
+	// Button and axis states are sampled from the bound devices and cached, so queries are plain array reads.
+	// They're sampled on every update(), and again on the next query if any bound device reports a state change
+	// (e.g. a press cleared by the UI), so update() must still be called every frame.
 	class InputVirtual : public InputDevice {
 	public:
 		InputVirtual(int nButtons, int nAxes);
@@ -90,9 +92,14 @@ namespace Halley {
 
 		JoystickType getJoystickType() const override;
 
+		// Includes the versions of the bound devices, so an InputVirtual bound into another one reports its devices' changes before its own update()
+		uint32_t getStateVersion() const override;
+
 	private:
 		void setLastDevice(InputDevice* device);
-		void updateLastDevice();
+		void onBindingsChanged();
+		InputDevice* sampleDevices(); // Returns the device that should become the last device, if any
+		void refreshIfStale();
 
 		struct Bind {
 			spInputDevice device;
@@ -130,9 +137,36 @@ namespace Halley {
 			explicit PositionBindData(spInputDevice device, int axisX, int axisY, float speed);
 		};
 
+		// Flattened copy of the binds, rebuilt whenever they change
+		struct CompiledBind {
+			InputDevice* device = nullptr;
+			int index = 0;
+			int a = -1;
+			int b = -1;
+			bool isAxisEmulation = false;
+			bool isManual = false;
+		};
+
+		enum ButtonStateFlags : uint8_t {
+			ButtonDown = 1,
+			ButtonPressed = 2,
+			ButtonPressedRepeat = 4,
+			ButtonReleased = 8
+		};
+
 		Vector<Vector<Bind>> buttons;
 		Vector<AxisData> axes;
 
+		Vector<CompiledBind> compiledButtonBinds;
+		Vector<CompiledBind> compiledAxisBinds;
+		Vector<InputDevice*> buttonDevices;
+		Vector<InputDevice*> allDevices;
+		Vector<uint32_t> sampledVersions; // State version of each of allDevices when last sampled
+
+		Vector<uint8_t> buttonStates;
+		Vector<float> axisValues;
+		uint8_t anyButtonState = 0;
+
 		Vector<PositionBindData> positions;
 		Maybe<Rect4f> positionLimits;
 		Vector2f position;
@@ -145,8 +179,6 @@ namespace Halley {
 		
 		float repeatDelayFirst;
 		float repeatDelayHold;
-
-		std::set<spInputDevice> getAllDevices() const;
 	};
 
 	typedef std::shared_ptr<InputVirtual> spInputVirtual;
@@ -4,6 +4,8 @@
 #include <memory>
 #include <gsl/span>
 #include "halley/resources/resource_data.h"
+#include "halley/data_structures/hash_map.h"
+#include "halley/utils/encrypt.h"
 
 namespace Halley {
 	enum class AssetType;
@@ -20,6 +22,9 @@ namespace Halley {
 		uint64_t dataStartPos;
 
 		void init(size_t assetDbSize);
+		bool isValid() const;
+		bool isSeekableEncryption() const;
+		void setSeekableEncryption();
 	};
 
     class AssetPack {
@@ -41,6 +46,7 @@ namespace Halley {
 		Bytes writeOut() const;
 
 		std::unique_ptr<ResourceData> getData(const String& asset, AssetType type, bool stream);
+		void prefetch(const String& asset, AssetType type);
 
 		void readToMemory();
 		void encrypt(const String& key);
@@ -58,6 +64,19 @@ namespace Halley {
 		size_t dataOffset = 0;
 		Bytes data;
 		std::array<char, 16> iv;
+		bool seekableEncryption = false;
+
+		// Set when data read through the reader needs to be decrypted on the fly
+		std::unique_ptr<Encrypt::CTRCipher> cipher;
+
+		constexpr static size_t maxPrefetchBytes = 64 * 1024 * 1024;
+		std::mutex prefetchMutex;
+		HashMap<String, std::unique_ptr<ResourceDataStatic>> prefetched;
+		size_t prefetchedBytes = 0;
+
+		Bytes getIV() const;
+		std::pair<size_t, size_t> getAssetRange(const String& asset, AssetType type) const;
+		static String getPrefetchKey(const String& asset, AssetType type);
     };
 
 
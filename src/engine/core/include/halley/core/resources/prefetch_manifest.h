@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vector>
+#include "halley/text/halleystring.h"
+
+namespace Halley {
+	enum class AssetType;
+	class Serializer;
+	class Deserializer;
+
+	// Ordered list of assets, as first requested during a recorded session (see Resources::startRecordingAccesses).
+	// Used by the packer to lay out pack data in access order, and at runtime to read ahead with Resources::prefetch.
+	class PrefetchManifest {
+	public:
+		struct Entry {
+			AssetType type;
+			String assetId;
+			float time; // Seconds since recording started
+
+			void serialize(Serializer& s) const;
+			void deserialize(Deserializer& s);
+		};
+
+		void add(AssetType type, const String& assetId, float time);
+		const std::vector<Entry>& getEntries() const;
+
+		void serialize(Serializer& s) const;
+		void deserialize(Deserializer& s);
+
+	private:
+		std::vector<Entry> entries;
+	};
+}
@@ -6,6 +6,7 @@
 #include <halley/text/halleystring.h>
 #include <halley/resources/resource_data.h>
 #include <halley/data_structures/hash_map.h>
+#include <halley/support/stats.h>
 
 namespace Halley
 {
@@ -63,6 +64,7 @@ namespace Halley
 		HashMap<String, Wrapper> resources;
 		AssetType type;
 		ResourceLoaderFunc resourceLoader;
+		StatHandle loadsStat;
 	};
 
 	template <typename T>
@@ -40,6 +40,7 @@ namespace Halley {
 		virtual const AssetDatabase& getAssetDatabase() = 0;
 		virtual int getPriority() const { return 0; }
 		virtual void purge(SystemAPI& system) = 0;
+		virtual void prefetch(const String& path, AssetType type) {}
 	};
 
 	class ResourceLocator : public IResourceLocator
@@ -55,6 +56,7 @@ namespace Halley {
 		std::unique_ptr<ResourceDataStatic> getStatic(const String& asset, AssetType type) override;
 		std::unique_ptr<ResourceDataStream> getStream(const String& asset, AssetType type) override;
 		void purge(const String& asset, AssetType type);
+		void prefetch(const String& asset, AssetType type);
 
 		std::vector<String> enumerate(const AssetType type);
 		bool exists(const String& asset);
@@ -23,9 +23,13 @@
 
 #include <ctime>
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <halley/support/exception.h>
 #include "halley/resources/resource.h"
 #include "resource_collection.h"
+#include "prefetch_manifest.h"
 #include "halley/text/string_converter.h"
 
 namespace Halley {
@@ -89,10 +93,32 @@ namespace Halley {
 		{
 			return of<T>().enumerate();
 		}
+
+		// Records every asset loaded from now on, in order, so the session can be replayed by the packer and the prefetcher
+		void startRecordingAccesses();
+		PrefetchManifest stopRecordingAccesses();
+
+		// Reads the raw data of every asset in the manifest ahead of time, in order, on the disk IO thread
+		void prefetch(const PrefetchManifest& manifest);
 		
 	private:
 		const std::unique_ptr<ResourceLocator> locator;
 		Vector<std::unique_ptr<ResourceCollectionBase>> resources;
 		const HalleyAPI* const api;
+
+		std::mutex recordingMutex;
+		std::unique_ptr<PrefetchManifest> recording;
+		std::chrono::steady_clock::time_point recordingStart;
+
+		// Shared with the prefetch tasks, so one that only starts after we're gone can tell without touching the locator
+		struct PrefetchState {
+			std::mutex mutex;
+			std::condition_variable finished;
+			bool cancelled = false;
+			int running = 0;
+		};
+		std::shared_ptr<PrefetchState> prefetchState;
+
+		void onFirstAccess(AssetType type, const String& assetId);
 	};
 }
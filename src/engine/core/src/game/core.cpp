@@ -13,6 +13,7 @@
 #include <halley/os/os.h>
 #include <halley/support/debug.h>
 #include <halley/support/console.h>
+#include <halley/support/memory_tracker.h>
 #include <halley/concurrency/concurrent.h>
 #include <fstream>
 #include <chrono>
@@ -45,6 +46,7 @@ Core::Core(std::unique_ptr<Game> g, Vector<std::string> _args)
 
 	// Basic initialization
 	game->init(*environment, args);
+	initStats();
 
 	// Console
 	if (game->shouldCreateSeparateConsole()) {
@@ -188,6 +190,11 @@ void Core::deInit()
 	running = false;
 	transitionStage();
 
+	dumpStats();
+	if (MemoryTracker::isEnabled()) {
+		Logger::logInfo(MemoryTracker::getReport());
+	}
+
 	// Deinit game
 	game->endGame();
 	game.reset();
@@ -292,6 +299,8 @@ void Core::onVariableUpdate(Time time)
 	if (isRunning()) {
 		doRender(time);
 	}
+
+	sampleStats();
 }
 
 void Core::doFixedUpdate(Time time)
@@ -381,6 +390,8 @@ void Core::doRender(Time)
 		}
 
 		painter->endRender();
+		drawCallsStat.set(int64_t(painter->getNumDrawCalls()));
+		verticesStat.set(int64_t(painter->getNumVertices()));
 
 		vsyncTimer.beginSample();
 		api->video->finishRender();
@@ -460,6 +471,52 @@ int64_t Core::getTime(CoreAPITimer timerType, TimeLine tl, StopwatchAveraging::M
 	}
 }
 
+void Core::initStats()
+{
+	const String dumpArg = "--stats-dump=";
+	for (auto& arg: args) {
+		if (arg.startsWith(dumpArg)) {
+			statsDumpPath = arg.mid(dumpArg.length());
+		}
+	}
+
+	frameTimeStats[int(TimeLine::FixedUpdate)] = Stats::get("frame.fixedNs", StatKind::Value);
+	frameTimeStats[int(TimeLine::VariableUpdate)] = Stats::get("frame.variableNs", StatKind::Value);
+	frameTimeStats[int(TimeLine::Render)] = Stats::get("frame.renderNs", StatKind::Value);
+	vsyncTimeStat = Stats::get("frame.vsyncNs", StatKind::Value);
+	drawCallsStat = Stats::get("render.drawCalls", StatKind::Value);
+	verticesStat = Stats::get("render.vertices", StatKind::Value);
+}
+
+void Core::sampleStats()
+{
+	for (int i = 0; i < int(TimeLine::NUMBER_OF_TIMELINES); ++i) {
+		frameTimeStats[i].set(engineTimers[i].lastElapsedNanoSeconds());
+	}
+	vsyncTimeStat.set(vsyncTimer.lastElapsedNanoSeconds());
+
+	MemoryTracker::publishStats();
+	if (auto stats = Stats::getInstance()) {
+		stats->sampleFrame();
+	}
+}
+
+void Core::dumpStats() const
+{
+	auto stats = Stats::getInstance();
+	if (statsDumpPath.isEmpty() || !stats) {
+		return;
+	}
+
+	std::ofstream out(statsDumpPath.c_str(), std::ios::out | std::ios::trunc);
+	if (!out) {
+		Logger::logError("Unable to write stats to \"" + statsDumpPath + "\"");
+		return;
+	}
+	out << (statsDumpPath.endsWith(".json") ? stats->toJSON() : stats->toCSV());
+	std::cout << "Stats written to " << statsDumpPath << std::endl;
+}
+
 void Core::initStage(Stage& stage)
 {
 	stage.api = &*api;
@@ -7,6 +7,7 @@
 #include <halley/concurrency/concurrent.h>
 #include <thread>
 #include "halley/support/logger.h"
+#include "halley/support/stats.h"
 #include "api/system_api.h"
 
 using namespace Halley;
@@ -18,6 +19,7 @@ namespace Halley {
 		HalleyStaticsPimpl()
 		{
 			logger = new Logger();
+			stats = std::make_unique<Stats>();
 			maskStorage = MaskStorageInterface::createMaskStorage();
 			os = OS::createOS();
 
@@ -37,6 +39,7 @@ namespace Halley {
 		void* maskStorage;
 		OS* os;
 		Logger* logger;
+		std::unique_ptr<Stats> stats;
 		
 		std::unique_ptr<Executors> executors;
 		std::unique_ptr<ThreadPool> cpuThreadPool;
@@ -80,6 +83,7 @@ void HalleyStatics::resume(SystemAPI* system)
 void HalleyStatics::setupGlobals() const
 {
 	Logger::setInstance(*pimpl->logger);
+	Stats::setInstance(pimpl->stats.get());
 
 	ComponentDeleterTable::getDeleters() = &pimpl->typeDeleters;
 	MaskStorageInterface::setMaskStorage(pimpl->maskStorage);
@@ -144,3 +144,13 @@ Vector2f Camera::worldToScreen(Vector2f p, Rect4f viewport) const
 {
 	return (p - pos).rotate(-angle) * zoom + viewport.getCenter();
 }
+
+Matrix4f Camera::getWorldToScreen(Rect4f viewport) const
+{
+	const auto center = viewport.getCenter();
+	auto result = Matrix4f::makeTranslation2D(center.x, center.y);
+	result.scale2D(zoom, zoom);
+	result.rotateZ(-angle);
+	result.translate2D(-pos.x, -pos.y);
+	return result;
+}
@@ -12,6 +12,11 @@
 #include "halley/audio/audio_position.h"
 #include "halley/support/logger.h"
 
+#if defined(_M_X64) || defined(__x86_64__)
+#define HALLEY_MOVIE_SSE2
+#include <emmintrin.h>
+#endif
+
 using namespace Halley;
 using namespace std::chrono_literals;
 
@@ -170,7 +175,19 @@ void MoviePlayer::render(Resources& resources, RenderContext& rc)
 			auto matDef = resources.get<MaterialDefinition>("Halley/NV12Video");
 			Sprite().setImage(currentTexture, matDef).setTexRect(Rect4f(0, 0, 1, 1)).setSize(Vector2f(videoSize)).draw(painter);
 		});
-		currentTexture.reset();
+
+		// The NV12 textures are only read here, so we're done with them after this. Hold on to each for one extra frame, so it's not overwritten while the GPU might still be reading it.
+		{
+			std::shared_ptr<MoviePlayerAliveFlag> alive = getAliveFlag();
+			std::unique_lock<std::mutex> lock(alive->mutex);
+			if (lastConvertedTexture) {
+				if (shouldRecycleTextures()) {
+					recycleTexture.push_back(lastConvertedTexture);
+				}
+				onDoneUsingTexture(std::move(lastConvertedTexture));
+			}
+		}
+		lastConvertedTexture = std::move(currentTexture);
 	}
 }
 
@@ -391,6 +408,15 @@ void MoviePlayer::onVideoFrameAvailable(Time time, TextureDescriptor&& descripto
 
 		if (tex) {
 			tex->load(std::move(descriptor));
+
+			// Backends upload synchronously and leave the pixel data in the descriptor, so hand it back for the next frame
+			auto bytes = descriptor.pixelData.moveBytes();
+			if (!bytes.empty()) {
+				std::unique_lock<std::mutex> lock(alive->mutex);
+				if (alive->isAlive && int(frameBufferPool.size()) < maxVideoFrames) {
+					frameBufferPool.push_back(std::move(bytes));
+				}
+			}
 		}
 	});
 }
@@ -402,13 +428,34 @@ void MoviePlayer::onVideoFrameAvailable(Time time, std::shared_ptr<Texture> text
 	pendingFrames.push_back({texture, time});
 }
 
-void MoviePlayer::onAudioFrameAvailable(Time time, gsl::span<const short> origSamples)
+static void convertSamples(gsl::span<const short> src, gsl::span<float> dst)
 {
-	std::vector<AudioConfig::SampleFormat> samples(origSamples.size());
-	for (size_t i = 0; i < size_t(origSamples.size()); ++i) {
-		samples[i] = origSamples[i] / 32768.0f;
+	const size_t n = size_t(src.size());
+	size_t i = 0;
+
+#ifdef HALLEY_MOVIE_SSE2
+	const __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+	for (; i + 8 <= n; i += 8) {
+		// Unpacking into the high half and shifting back down sign extends to 32 bits
+		const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src.data() + i));
+		const __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+		const __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+		_mm_storeu_ps(dst.data() + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+		_mm_storeu_ps(dst.data() + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+	}
+#endif
+
+	for (; i < n; ++i) {
+		dst[i] = src[i] / 32768.0f;
 	}
-	onAudioFrameAvailable(time, gsl::span<const AudioConfig::SampleFormat>(samples.data(), samples.size()));
+}
+
+void MoviePlayer::onAudioFrameAvailable(Time time, gsl::span<const short> origSamples)
+{
+	// Only called from the decoding thread, so the conversion buffer can be reused between frames
+	audioConversionBuffer.resize(size_t(origSamples.size()));
+	convertSamples(origSamples, audioConversionBuffer);
+	onAudioFrameAvailable(time, gsl::span<const AudioConfig::SampleFormat>(audioConversionBuffer.data(), audioConversionBuffer.size()));
 }
 
 void MoviePlayer::onAudioFrameAvailable(Time time, gsl::span<const AudioConfig::SampleFormat> samples)
@@ -416,6 +463,21 @@ void MoviePlayer::onAudioFrameAvailable(Time time, gsl::span<const AudioConfig::
 	streamingClip->addInterleavedSamples(samples);	
 }
 
+Bytes MoviePlayer::getFrameBuffer(size_t size)
+{
+	Bytes result;
+	{
+		std::shared_ptr<MoviePlayerAliveFlag> alive = getAliveFlag();
+		std::unique_lock<std::mutex> lock(alive->mutex);
+		if (!frameBufferPool.empty()) {
+			result = std::move(frameBufferPool.back());
+			frameBufferPool.pop_back();
+		}
+	}
+	result.resize(size);
+	return result;
+}
+
 std::shared_ptr<MoviePlayerAliveFlag> MoviePlayer::getAliveFlag() const
 {
 	return aliveFlag;
@@ -4,9 +4,12 @@
 #include "halley/core/graphics/material/material.h"
 #include "halley/core/graphics/material/material_definition.h"
 #include "halley/core/graphics/material/material_parameter.h"
+#include <algorithm>
 #include <cstring> // memmove
 #include <gsl/gsl_assert>
+#include <limits>
 #include "resources/resources.h"
+#include "halley/support/memory_tracker.h"
 
 using namespace Halley;
 
@@ -33,6 +36,7 @@ void Painter::startRender()
 
 void Painter::endRender()
 {
+	MemoryTagScope memTag(MemoryTag::Graphics);
 	flush();
 	doEndRender();
 	camera = nullptr;
@@ -61,7 +65,12 @@ Painter::PainterVertexData Painter::addDrawData(std::shared_ptr<Material>& mater
 	Expects(material);
 	Expects(numVertices > 0);
 	Expects(numIndices >= numVertices);
+	Expects(numVertices <= size_t(std::numeric_limits<unsigned short>::max()) + 1);
 
+	if (verticesPending + numVertices > size_t(std::numeric_limits<unsigned short>::max()) + 1) {
+		// Indices are 16-bit, so start a new batch before they overflow
+		flushPending();
+	}
 	startDrawCall(material);
 
 	PainterVertexData result;
@@ -100,6 +109,17 @@ void Painter::drawSprites(std::shared_ptr<Material> material, size_t numSprites,
 	Expects(vertexData != nullptr);
 
 	const size_t verticesPerSprite = 4;
+	const size_t maxSpritesPerCall = (size_t(std::numeric_limits<unsigned short>::max()) + 1) / verticesPerSprite;
+	if (numSprites > maxSpritesPerCall) {
+		// Indices are 16-bit, so submit in chunks that fit a single batch each
+		const size_t stride = material->getDefinition().getVertexStride();
+		const char* const src = reinterpret_cast<const char*>(vertexData);
+		for (size_t start = 0; start < numSprites; start += maxSpritesPerCall) {
+			drawSprites(material, std::min(numSprites - start, maxSpritesPerCall), src + start * stride);
+		}
+		return;
+	}
+
 	const size_t numVertices = verticesPerSprite * numSprites;
 	const size_t vertPosOffset = material->getDefinition().getVertexPosOffset();
 
@@ -225,12 +245,13 @@ void Painter::unbind(RenderContext& context)
 void Painter::setRelativeClip(Rect4f rect)
 {
 	std::array<Vector2f, 4> ps = {{ rect.getTopLeft(), rect.getTopRight(), rect.getBottomLeft(), rect.getBottomRight() }};
+	camera->getWorldToScreen(Rect4f(viewPort)).transformPoints(ps);
+
 	float x0 = -std::numeric_limits<float>::infinity();
 	float x1 = std::numeric_limits<float>::infinity();
 	float y0 = -std::numeric_limits<float>::infinity();
 	float y1 = std::numeric_limits<float>::infinity();
-	for (auto& p: ps) {
-		auto point = camera->worldToScreen(p, Rect4f(viewPort));
+	for (auto& point: ps) {
 		x0 = std::max(x0, point.x);
 		x1 = std::min(x1, point.x);
 		y0 = std::max(y0, point.y);
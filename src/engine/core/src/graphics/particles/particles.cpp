@@ -0,0 +1,301 @@
+#include "graphics/particles/particles.h"
+#include "halley/core/graphics/painter.h"
+#include "halley/concurrency/concurrent.h"
+#include "halley/utils/utils.h"
+#include <algorithm>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386)
+#define HAS_SSE
+#include <xmmintrin.h>
+#endif
+
+using namespace Halley;
+
+ParticleCurve::ParticleCurve(float constant)
+{
+	samples.fill(constant);
+}
+
+ParticleCurve::ParticleCurve(std::initializer_list<std::pair<float, float>> keyframes)
+{
+	Expects(keyframes.size() > 0);
+	std::vector<std::pair<float, float>> keys(keyframes);
+
+	for (size_t i = 0; i <= resolution; ++i) {
+		const float t = float(i) / float(resolution);
+		const auto next = std::find_if(keys.begin(), keys.end(), [&] (const std::pair<float, float>& k) { return k.first >= t; });
+		if (next == keys.begin()) {
+			samples[i] = next->second;
+		} else if (next == keys.end()) {
+			samples[i] = keys.back().second;
+		} else {
+			const auto& prev = *(next - 1);
+			const float len = next->first - prev.first;
+			const float f = len > 0 ? (t - prev.first) / len : 1.0f;
+			samples[i] = lerp(prev.second, next->second, f);
+		}
+	}
+}
+
+float ParticleCurve::evaluate(float t) const
+{
+	const float pos = clamp(t, 0.0f, 1.0f) * float(resolution);
+	const size_t i = std::min(size_t(pos), resolution - 1);
+	return lerp(samples[i], samples[i + 1], pos - float(i));
+}
+
+ParticleEmitter::ParticleEmitter(ParticleEmitterConfig config, Sprite sprite)
+	: config(std::move(config))
+	, sprite(std::move(sprite))
+	, rng(Random::getThreadLocal().getRawInt())
+{
+	reserve(std::min(this->config.maxParticles, size_t(256)));
+}
+
+void ParticleEmitter::setPosition(Vector2f pos)
+{
+	position = pos;
+}
+
+Vector2f ParticleEmitter::getPosition() const
+{
+	return position;
+}
+
+void ParticleEmitter::setEnabled(bool e)
+{
+	enabled = e;
+	if (!enabled) {
+		pendingSpawn = 0;
+	}
+}
+
+bool ParticleEmitter::isEnabled() const
+{
+	return enabled;
+}
+
+void ParticleEmitter::burst(size_t n)
+{
+	spawn(n);
+}
+
+void ParticleEmitter::clear()
+{
+	count = 0;
+	pendingSpawn = 0;
+}
+
+size_t ParticleEmitter::getNumParticles() const
+{
+	return count;
+}
+
+bool ParticleEmitter::isIdle() const
+{
+	return !enabled && count == 0;
+}
+
+const ParticleEmitterConfig& ParticleEmitter::getConfig() const
+{
+	return config;
+}
+
+ParticleEmitterConfig& ParticleEmitter::getConfig()
+{
+	return config;
+}
+
+void ParticleEmitter::update(Time t)
+{
+	const float dt = float(t);
+
+	integrate(dt);
+	removeDead();
+
+	if (enabled) {
+		pendingSpawn += config.spawnRate * dt;
+		const size_t n = size_t(pendingSpawn);
+		pendingSpawn -= float(n);
+		spawn(n);
+	}
+}
+
+void ParticleEmitter::draw(Painter& painter) const
+{
+	if (count == 0 || !sprite.hasMaterial()) {
+		return;
+	}
+
+	const auto& base = sprite.getVertexAttrib();
+	vertices.resize(count);
+	for (size_t i = 0; i < count; ++i) {
+		const float t = age[i];
+		const float colourT = config.colourCurve.evaluate(t);
+		const float particleScale = scale[i] * config.scaleCurve.evaluate(t);
+
+		auto& v = vertices[i];
+		v = base;
+		v.pos = Vector2f(posX[i], posY[i]);
+		v.rotation = base.rotation + rotation[i];
+		v.scale = base.scale * particleScale;
+		v.colour = Colour4f(
+			base.colour.r * lerp(config.startColour.r, config.endColour.r, colourT),
+			base.colour.g * lerp(config.startColour.g, config.endColour.g, colourT),
+			base.colour.b * lerp(config.startColour.b, config.endColour.b, colourT),
+			base.colour.a * lerp(config.startColour.a, config.endColour.a, colourT) * config.alphaCurve.evaluate(t));
+	}
+
+	painter.drawSprites(sprite.getMaterialPtr(), count, vertices.data());
+}
+
+void ParticleEmitter::reserve(size_t n)
+{
+	// Keep room for a full SIMD lane past the end, so integrate never needs a scalar tail
+	const size_t capacity = alignUp(n, size_t(4));
+	if (capacity <= posX.size()) {
+		return;
+	}
+	for (auto* v: { &posX, &posY, &velX, &velY, &age, &ageRate, &rotation, &rotationSpeed, &scale }) {
+		v->resize(capacity, 0.0f);
+	}
+}
+
+void ParticleEmitter::spawn(size_t n)
+{
+	n = std::min(n, config.maxParticles - std::min(count, config.maxParticles));
+	if (n == 0) {
+		return;
+	}
+	reserve(std::max(count + n, std::min(posX.size() * 2, config.maxParticles)));
+
+	for (size_t i = count; i < count + n; ++i) {
+		const Vector2f offset(rng.getFloat(-config.spawnArea.x, config.spawnArea.x), rng.getFloat(-config.spawnArea.y, config.spawnArea.y));
+		const float angle = config.direction.getRadians() + rng.getFloat(-1.0f, 1.0f) * config.directionScatter.getRadians();
+		const float speed = rng.getFloat(config.speed.start, config.speed.end);
+		const float lifetime = std::max(rng.getFloat(config.lifetime.start, config.lifetime.end), 0.001f);
+
+		posX[i] = position.x + offset.x;
+		posY[i] = position.y + offset.y;
+		velX[i] = std::cos(angle) * speed;
+		velY[i] = std::sin(angle) * speed;
+		age[i] = 0;
+		ageRate[i] = 1.0f / lifetime;
+		rotation[i] = 0;
+		rotationSpeed[i] = rng.getFloat(config.rotationSpeed.start, config.rotationSpeed.end);
+		scale[i] = rng.getFloat(config.startScale.start, config.startScale.end);
+	}
+	count += n;
+}
+
+void ParticleEmitter::integrate(float dt)
+{
+	const float damping = std::max(0.0f, 1.0f - config.drag * dt);
+	const float accelX = config.acceleration.x * dt;
+	const float accelY = config.acceleration.y * dt;
+	size_t i = 0;
+
+#ifdef HAS_SSE
+	const size_t nPacked = alignUp(count, size_t(4));
+	const __m128 dt4 = _mm_set1_ps(dt);
+	const __m128 damping4 = _mm_set1_ps(damping);
+	const __m128 accelX4 = _mm_set1_ps(accelX);
+	const __m128 accelY4 = _mm_set1_ps(accelY);
+	for (; i < nPacked; i += 4) {
+		const __m128 vx = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&velX[i]), damping4), accelX4);
+		const __m128 vy = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&velY[i]), damping4), accelY4);
+		_mm_storeu_ps(&velX[i], vx);
+		_mm_storeu_ps(&velY[i], vy);
+		_mm_storeu_ps(&posX[i], _mm_add_ps(_mm_loadu_ps(&posX[i]), _mm_mul_ps(vx, dt4)));
+		_mm_storeu_ps(&posY[i], _mm_add_ps(_mm_loadu_ps(&posY[i]), _mm_mul_ps(vy, dt4)));
+		_mm_storeu_ps(&age[i], _mm_add_ps(_mm_loadu_ps(&age[i]), _mm_mul_ps(_mm_loadu_ps(&ageRate[i]), dt4)));
+		_mm_storeu_ps(&rotation[i], _mm_add_ps(_mm_loadu_ps(&rotation[i]), _mm_mul_ps(_mm_loadu_ps(&rotationSpeed[i]), dt4)));
+	}
+#endif
+
+	for (; i < count; ++i) {
+		velX[i] = velX[i] * damping + accelX;
+		velY[i] = velY[i] * damping + accelY;
+		posX[i] += velX[i] * dt;
+		posY[i] += velY[i] * dt;
+		age[i] += ageRate[i] * dt;
+		rotation[i] += rotationSpeed[i] * dt;
+	}
+}
+
+void ParticleEmitter::removeDead()
+{
+	// Swap dead particles with the last live one, which keeps the arrays packed
+	for (size_t i = 0; i < count; ) {
+		if (age[i] >= 1.0f) {
+			const size_t last = --count;
+			posX[i] = posX[last];
+			posY[i] = posY[last];
+			velX[i] = velX[last];
+			velY[i] = velY[last];
+			age[i] = age[last];
+			ageRate[i] = ageRate[last];
+			rotation[i] = rotation[last];
+			rotationSpeed[i] = rotationSpeed[last];
+			scale[i] = scale[last];
+		} else {
+			++i;
+		}
+	}
+}
+
+ParticleEmitter& ParticleSystem::addEmitter(ParticleEmitterConfig config, Sprite sprite)
+{
+	emitters.push_back(std::make_unique<ParticleEmitter>(std::move(config), std::move(sprite)));
+	return *emitters.back();
+}
+
+void ParticleSystem::removeEmitter(const ParticleEmitter& emitter)
+{
+	emitters.erase(std::remove_if(emitters.begin(), emitters.end(), [&] (const std::unique_ptr<ParticleEmitter>& e) { return e.get() == &emitter; }), emitters.end());
+}
+
+void ParticleSystem::removeIdleEmitters()
+{
+	emitters.erase(std::remove_if(emitters.begin(), emitters.end(), [&] (const std::unique_ptr<ParticleEmitter>& e) { return e->isIdle(); }), emitters.end());
+}
+
+void ParticleSystem::clear()
+{
+	emitters.clear();
+}
+
+size_t ParticleSystem::getNumEmitters() const
+{
+	return emitters.size();
+}
+
+size_t ParticleSystem::getNumParticles() const
+{
+	size_t total = 0;
+	for (auto& e: emitters) {
+		total += e->getNumParticles();
+	}
+	return total;
+}
+
+void ParticleSystem::update(Time t, bool parallel)
+{
+	if (parallel && emitters.size() > 1) {
+		Concurrent::foreach(emitters.begin(), emitters.end(), [t] (std::unique_ptr<ParticleEmitter>& e)
+		{
+			e->update(t);
+		});
+	} else {
+		for (auto& e: emitters) {
+			e->update(t);
+		}
+	}
+}
+
+void ParticleSystem::draw(Painter& painter) const
+{
+	for (auto& e: emitters) {
+		e->draw(painter);
+	}
+}
@@ -21,6 +21,12 @@ AnimationFrame::AnimationFrame(int frameNumber, int duration, const String& imag
 	}
 }
 
+AnimationFrame::AnimationFrame(int duration, Vector<const SpriteSheetEntry*> sprites)
+	: sprites(std::move(sprites))
+	, duration(duration)
+{
+}
+
 int AnimationFrame::getDuration() const
 {
 	return duration;
@@ -39,14 +45,36 @@ AnimationFrameDefinition::AnimationFrameDefinition(int frameNumber, int duration
 
 AnimationFrame AnimationFrameDefinition::makeFrame(const SpriteSheet& sheet, const Vector<AnimationDirection>& directions) const
 {
+	if (spriteNameHashes.size() == directions.size()) {
+		Vector<const SpriteSheetEntry*> sprites(directions.size());
+		if (sheet.tryGetSprites(gsl::span<const uint64_t>(spriteNameHashes.data(), spriteNameHashes.size()), gsl::span<const SpriteSheetEntry*>(sprites.data(), sprites.size()))) {
+			return AnimationFrame(duration, std::move(sprites));
+		}
+	}
+
+	// Not hashed, or something is missing; go by name, which reports missing sprites properly
 	return AnimationFrame(frameNumber, duration, imageName, sheet, directions);
 }
 
+void AnimationFrameDefinition::hashSpriteNames(const Vector<AnimationDirection>& directions)
+{
+	spriteNameHashes.resize(directions.size());
+	for (size_t i = 0; i < directions.size(); ++i) {
+		spriteNameHashes[i] = SpriteSheet::getNameHash(getSpriteName(directions[i]));
+	}
+}
+
+String AnimationFrameDefinition::getSpriteName(const AnimationDirection& direction) const
+{
+	return direction.needsToProcessFrameName(imageName) ? direction.getFrameName(frameNumber, imageName) : imageName;
+}
+
 void AnimationFrameDefinition::serialize(Serializer& s) const
 {
 	s << imageName;
 	s << frameNumber;
 	s << duration;
+	s << spriteNameHashes;
 }
 
 void AnimationFrameDefinition::deserialize(Deserializer& s)
@@ -54,6 +82,7 @@ void AnimationFrameDefinition::deserialize(Deserializer& s)
 	s >> imageName;
 	s >> frameNumber;
 	s >> duration;
+	s >> spriteNameHashes;
 }
 
 AnimationSequence::AnimationSequence() {}
@@ -215,11 +244,19 @@ void Animation::setSpriteSheetName(const String& n)
 void Animation::addSequence(const AnimationSequence& sequence)
 {
 	sequences.push_back(sequence);
+	for (auto& f: sequences.back().frameDefinitions) {
+		f.hashSpriteNames(directions);
+	}
 }
 
 void Animation::addDirection(const AnimationDirection& direction)
 {
 	directions.push_back(direction);
+	for (auto& s: sequences) {
+		for (auto& f: s.frameDefinitions) {
+			f.hashSpriteNames(directions);
+		}
+	}
 }
 
 const AnimationSequence& Animation::getSequence(const String& seqName) const
@@ -5,6 +5,8 @@
 #include "halley/file_formats/json/json.h"
 #include <halley/file_formats/json_file.h>
 #include "halley/bytes/byte_serializer.h"
+#include "halley/utils/hash.h"
+#include <algorithm>
 
 using namespace Halley;
 
@@ -104,8 +106,8 @@ size_t SpriteSheet::getSpriteCount() const
 
 size_t SpriteSheet::getIndex(const String& name) const
 {
-	auto iter = spriteIdx.find(name);
-	if (iter == spriteIdx.end()) {
+	const auto idx = tryGetIndex(getNameHash(name));
+	if (!idx) {
 		String names = "";
 		bool first = true;
 		for (auto& f: spriteIdx) {
@@ -122,13 +124,41 @@ size_t SpriteSheet::getIndex(const String& name) const
 		}
 		throw Exception("Spritesheet does not contain sprite \"" + name + "\".\nSprites: { " + names + " }.", HalleyExceptions::Resources);
 	} else {
-		return size_t(iter->second);
+		return idx.get();
 	}
 }
 
 bool SpriteSheet::hasSprite(const String& name) const
 {
-	return spriteIdx.find(name) != spriteIdx.end();
+	return static_cast<bool>(tryGetIndex(getNameHash(name)));
+}
+
+uint64_t SpriteSheet::getNameHash(const String& name)
+{
+	return Hash::hash(gsl::as_bytes(gsl::span<const char>(name.c_str(), name.length())));
+}
+
+Maybe<size_t> SpriteSheet::tryGetIndex(uint64_t nameHash) const
+{
+	const auto iter = std::lower_bound(nameHashes.begin(), nameHashes.end(), nameHash);
+	if (iter != nameHashes.end() && *iter == nameHash) {
+		return size_t(nameHashIndices[iter - nameHashes.begin()]);
+	}
+	return {};
+}
+
+bool SpriteSheet::tryGetSprites(gsl::span<const uint64_t> hashes, gsl::span<const SpriteSheetEntry*> result) const
+{
+	Expects(hashes.size() == result.size());
+
+	for (std::ptrdiff_t i = 0; i < hashes.size(); ++i) {
+		const auto idx = tryGetIndex(hashes[i]);
+		if (!idx) {
+			return false;
+		}
+		result[i] = &sprites[idx.get()];
+	}
+	return true;
 }
 
 std::unique_ptr<SpriteSheet> SpriteSheet::loadResource(ResourceLoader& loader)
@@ -149,8 +179,22 @@ void SpriteSheet::loadTexture(Resources& resources) const
 
 void SpriteSheet::addSprite(String name, const SpriteSheetEntry& sprite)
 {
+	const auto idx = uint32_t(sprites.size());
+	const auto hash = getNameHash(name);
+	const auto iter = std::lower_bound(nameHashes.begin(), nameHashes.end(), hash);
+	const auto pos = iter - nameHashes.begin();
+	if (iter != nameHashes.end() && *iter == hash) {
+		if (spriteIdx.find(name) == spriteIdx.end()) {
+			throw Exception("Sprite name \"" + name + "\" has the same hash as another sprite in the spritesheet.", HalleyExceptions::Resources);
+		}
+		nameHashIndices[pos] = idx;
+	} else {
+		nameHashes.insert(iter, hash);
+		nameHashIndices.insert(nameHashIndices.begin() + pos, idx);
+	}
+
 	sprites.push_back(sprite);
-	spriteIdx[name] = uint32_t(sprites.size() - 1);
+	spriteIdx[name] = idx;
 }
 
 void SpriteSheet::setTextureName(String name)
@@ -169,6 +213,8 @@ void SpriteSheet::serialize(Serializer& s) const
 	s << sprites;
 	s << spriteIdx;
 	s << frameTags;
+	s << nameHashes;
+	s << nameHashIndices;
 }
 
 void SpriteSheet::deserialize(Deserializer& s)
@@ -177,6 +223,8 @@ void SpriteSheet::deserialize(Deserializer& s)
 	s >> sprites;
 	s >> spriteIdx;
 	s >> frameTags;
+	s >> nameHashes;
+	s >> nameHashIndices;
 }
 
 void SpriteSheet::loadJson(gsl::span<const gsl::byte> data)
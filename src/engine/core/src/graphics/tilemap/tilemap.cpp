@@ -0,0 +1,262 @@
+#include "graphics/tilemap/tilemap.h"
+#include "halley/core/graphics/painter.h"
+#include "halley/core/graphics/material/material.h"
+#include "halley/core/graphics/material/material_definition.h"
+#include "halley/bytes/byte_serializer.h"
+#include "halley/support/exception.h"
+
+using namespace Halley;
+
+TileSet::TileSet() = default;
+
+TileSet::TileSet(std::shared_ptr<Material> material, Vector2f tileSize)
+	: material(std::move(material))
+	, tileSize(tileSize)
+{
+}
+
+TileSet TileSet::fromGrid(std::shared_ptr<Material> material, Vector2f tileSize, Vector2i gridSize)
+{
+	TileSet result(std::move(material), tileSize);
+	const Vector2f cell = Vector2f(1.0f / gridSize.x, 1.0f / gridSize.y);
+	for (int y = 0; y < gridSize.y; ++y) {
+		for (int x = 0; x < gridSize.x; ++x) {
+			result.addTile(Rect4f(Vector2f(float(x), float(y)) * cell, cell.x, cell.y));
+		}
+	}
+	return result;
+}
+
+TileId TileSet::addTile(Rect4f texRect)
+{
+	if (texRects.size() >= emptyTile) {
+		throw Exception("Too many tiles in tile set.", HalleyExceptions::Graphics);
+	}
+	texRects.push_back(texRect);
+	return TileId(texRects.size() - 1);
+}
+
+Rect4f TileSet::getTexRect(TileId id) const
+{
+	return texRects.at(id);
+}
+
+size_t TileSet::getNumTiles() const
+{
+	return texRects.size();
+}
+
+const std::shared_ptr<Material>& TileSet::getMaterial() const
+{
+	return material;
+}
+
+Vector2f TileSet::getTileSize() const
+{
+	return tileSize;
+}
+
+TileMap::TileMap() = default;
+
+TileMap::TileMap(Vector2i size, int chunkSize)
+	: size(size)
+	, chunkSize(chunkSize)
+	, tiles(size_t(size.x * size.y), emptyTile)
+{
+	Expects(size.x >= 0 && size.y >= 0);
+	Expects(chunkSize > 0 && chunkSize * chunkSize * 4 <= 65536); // Each chunk must fit in a single 16-bit indexed batch
+	resetChunks();
+}
+
+Vector2i TileMap::getSize() const
+{
+	return size;
+}
+
+int TileMap::getChunkSize() const
+{
+	return chunkSize;
+}
+
+Vector2i TileMap::getNumChunks() const
+{
+	return numChunks;
+}
+
+TileId TileMap::getTile(Vector2i pos) const
+{
+	if (pos.x < 0 || pos.y < 0 || pos.x >= size.x || pos.y >= size.y) {
+		return emptyTile;
+	}
+	return tiles[size_t(pos.x + pos.y * size.x)];
+}
+
+void TileMap::setTile(Vector2i pos, TileId tile)
+{
+	if (pos.x < 0 || pos.y < 0 || pos.x >= size.x || pos.y >= size.y) {
+		throw Exception("Tile position out of bounds: " + toString(pos.x) + ", " + toString(pos.y), HalleyExceptions::Graphics);
+	}
+	auto& t = tiles[size_t(pos.x + pos.y * size.x)];
+	if (t != tile) {
+		t = tile;
+		++chunkRevisions[getChunkIndex(Vector2i(pos.x / chunkSize, pos.y / chunkSize))];
+	}
+}
+
+void TileMap::fill(Rect4i area, TileId tile)
+{
+	const auto clipped = area.intersection(Rect4i(Vector2i(), size));
+	for (int y = clipped.getTop(); y < clipped.getBottom(); ++y) {
+		for (int x = clipped.getLeft(); x < clipped.getRight(); ++x) {
+			setTile(Vector2i(x, y), tile);
+		}
+	}
+}
+
+uint32_t TileMap::getChunkRevision(Vector2i chunk) const
+{
+	return chunkRevisions[getChunkIndex(chunk)];
+}
+
+void TileMap::serialize(Serializer& s) const
+{
+	s << size << chunkSize << tiles;
+}
+
+void TileMap::deserialize(Deserializer& s)
+{
+	s >> size >> chunkSize >> tiles;
+	if (chunkSize <= 0 || size.x < 0 || size.y < 0 || tiles.size() != size_t(size.x * size.y)) {
+		throw Exception("Invalid tile map data.", HalleyExceptions::Graphics);
+	}
+	resetChunks();
+}
+
+void TileMap::resetChunks()
+{
+	numChunks = Vector2i((size.x + chunkSize - 1) / chunkSize, (size.y + chunkSize - 1) / chunkSize);
+
+	// Keep revisions moving forward, so renderers holding old geometry notice the change
+	uint32_t base = 1;
+	for (auto r: chunkRevisions) {
+		base = std::max(base, r + 1);
+	}
+	chunkRevisions.assign(size_t(numChunks.x * numChunks.y), base);
+}
+
+size_t TileMap::getChunkIndex(Vector2i chunk) const
+{
+	return size_t(chunk.x + chunk.y * numChunks.x);
+}
+
+TileMapRenderer::TileMapRenderer(std::shared_ptr<const TileMap> map, TileSet tileSet)
+	: map(std::move(map))
+	, tileSet(std::move(tileSet))
+{
+	Expects(this->map);
+	Expects(this->tileSet.getMaterial());
+	Expects(this->tileSet.getMaterial()->getDefinition().getVertexStride() == sizeof(SpriteVertexAttrib));
+}
+
+void TileMapRenderer::setPosition(Vector2f pos)
+{
+	position = pos;
+	invalidate();
+}
+
+Vector2f TileMapRenderer::getPosition() const
+{
+	return position;
+}
+
+void TileMapRenderer::setColour(Colour4f c)
+{
+	colour = c;
+	invalidate();
+}
+
+void TileMapRenderer::draw(Painter& painter) const
+{
+	draw(painter, painter.getWorldViewAABB());
+}
+
+void TileMapRenderer::draw(Painter& painter, Rect4f view) const
+{
+	const auto numChunks = map->getNumChunks();
+	const size_t totalChunks = size_t(numChunks.x * numChunks.y);
+	if (chunks.size() != totalChunks) {
+		chunks.clear();
+		chunks.resize(totalChunks);
+	}
+
+	// Only visit chunks overlapping the view
+	const Vector2f chunkWorldSize = tileSet.getTileSize() * float(map->getChunkSize());
+	const Vector2f start = (view.getTopLeft() - position) / chunkWorldSize;
+	const Vector2f end = (view.getBottomRight() - position) / chunkWorldSize;
+	const int x0 = std::max(0, int(std::floor(start.x)));
+	const int y0 = std::max(0, int(std::floor(start.y)));
+	const int x1 = std::min(numChunks.x, int(std::ceil(end.x)));
+	const int y1 = std::min(numChunks.y, int(std::ceil(end.y)));
+
+	const auto& material = tileSet.getMaterial();
+	for (int y = y0; y < y1; ++y) {
+		for (int x = x0; x < x1; ++x) {
+			const Vector2i chunkPos(x, y);
+			auto& chunk = chunks[size_t(x + y * numChunks.x)];
+			if (!chunk.built || chunk.revision != map->getChunkRevision(chunkPos)) {
+				buildChunk(chunkPos, chunk);
+			}
+			if (!chunk.vertices.empty()) {
+				painter.drawQuads(material, chunk.vertices.size(), chunk.vertices.data());
+			}
+		}
+	}
+}
+
+void TileMapRenderer::invalidate()
+{
+	for (auto& c: chunks) {
+		c.built = false;
+	}
+}
+
+void TileMapRenderer::buildChunk(Vector2i chunkPos, Chunk& chunk) const
+{
+	const int chunkSize = map->getChunkSize();
+	const Vector2f tileSize = tileSet.getTileSize();
+	const Vector2i origin = chunkPos * chunkSize;
+	const Vector2i end = Vector2i(std::min(origin.x + chunkSize, map->getSize().x), std::min(origin.y + chunkSize, map->getSize().y));
+
+	SpriteVertexAttrib vertex;
+	vertex.pivot = Vector2f();
+	vertex.size = tileSize;
+	vertex.scale = Vector2f(1, 1);
+	vertex.colour = colour;
+	vertex.rotation = 0;
+	vertex.textureRotation = 0;
+
+	chunk.vertices.clear();
+	chunk.vertices.reserve(size_t(chunkSize * chunkSize * 4));
+	for (int y = origin.y; y < end.y; ++y) {
+		for (int x = origin.x; x < end.x; ++x) {
+			const TileId tile = map->getTile(Vector2i(x, y));
+			if (tile == emptyTile || tile >= tileSet.getNumTiles()) {
+				continue;
+			}
+
+			vertex.pos = position + Vector2f(float(x), float(y)) * tileSize;
+			vertex.texRect = tileSet.getTexRect(tile);
+
+			// Same corner layout Painter::drawSprites generates
+			for (int j = 0; j < 4; ++j) {
+				const float vx = float((j & 1) ^ ((j & 2) >> 1));
+				const float vy = float((j & 2) >> 1);
+				vertex.vertPos = Vector4f(vx, vy, vx, vy);
+				chunk.vertices.push_back(vertex);
+			}
+		}
+	}
+
+	chunk.revision = map->getChunkRevision(chunkPos);
+	chunk.built = true;
+}
@@ -35,10 +35,12 @@ void InputButtonBase::init(int nButtons)
 	buttonPressedRepeat.resize(nButtons);
 	buttonReleased.resize(nButtons);
 	buttonDown.resize(nButtons);
+	notifyStateChanged();
 }
 
 void InputButtonBase::onButtonPressed(int code)
 {
+	notifyStateChanged();
 	buttonPressedRepeat[code] = true;
 	if (!buttonDown[code]) {
 		buttonPressed[code] = true;
@@ -49,6 +51,7 @@ void InputButtonBase::onButtonPressed(int code)
 
 void InputButtonBase::onButtonReleased(int code)
 {
+	notifyStateChanged();
 	if (buttonDown[code]) {
 		// See comment on method above
 		buttonReleased[code] = true;
@@ -60,6 +63,7 @@ void InputButtonBase::onButtonStatus(int code, bool down)
 {
 	// This method should probably not be used with the two above
 	// This is designed for polled input, such as XInput controllers
+	notifyStateChanged();
 	bool wasDown = buttonDown[code] != 0;
 	buttonDown[code] = down;
 	if (wasDown && !down) buttonReleased[code] = true;
@@ -81,6 +85,7 @@ InputDevice* InputButtonBase::getParent() const
 
 void InputButtonBase::clearPresses()
 {
+	notifyStateChanged();
 	size_t len = buttonPressed.size();
 	for (size_t i=0; i<len; i++) {
 		buttonPressed[i] = 0;
@@ -150,6 +155,7 @@ String InputButtonBase::getButtonName(int code)
 
 void InputButtonBase::clearButton(int code)
 {
+	notifyStateChanged();
 	if (code >= 0 && code < int(buttonPressedRepeat.size())) {
 		buttonPressed[code] = 0;
 		buttonPressedRepeat[code] = 0;
@@ -160,6 +166,7 @@ void InputButtonBase::clearButton(int code)
 
 void InputButtonBase::clearButtonPress(int code)
 {
+	notifyStateChanged();
 	if (code >= 0 && code < int(buttonPressedRepeat.size())) {
 		buttonPressed[code] = 0;
 		buttonPressedRepeat[code] = 0;
@@ -168,6 +175,7 @@ void InputButtonBase::clearButtonPress(int code)
 
 void InputButtonBase::clearButtonRelease(int code)
 {
+	notifyStateChanged();
 	if (code >= 0 && code < int(buttonPressedRepeat.size())) {
 		buttonReleased[code] = 0;
 	}
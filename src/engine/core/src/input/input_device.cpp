@@ -130,3 +130,8 @@ InputDevice* InputDevice::getParent() const
 {
 	return nullptr;
 }
+
+uint32_t InputDevice::getStateVersion() const
+{
+	return stateVersion;
+}
@@ -69,6 +69,7 @@ void Halley::InputManual::releaseButton(int n)
 void Halley::InputManual::setAxis(int n, float value)
 {
 	axes.at(n) = value;
+	notifyStateChanged();
 }
 
 size_t Halley::InputManual::getNumberAxes()
@@ -21,7 +21,6 @@
 
 #include "input/input_virtual.h"
 #include "input/input_manual.h"
-#include <set>
 #include <algorithm>
 
 using namespace Halley;
@@ -33,11 +32,13 @@ InputVirtual::InputVirtual(int nButtons, int nAxes)
 {
 	buttons.resize(nButtons);
 	axes.resize(nAxes);
+	buttonStates.resize(nButtons, 0);
+	axisValues.resize(nAxes, 0.0f);
 }
 
 bool InputVirtual::isEnabled() const
 {
-	for (auto& d: getAllDevices()) {
+	for (auto& d: allDevices) {
 		if (d->isEnabled()) {
 			return true;
 		}
@@ -67,94 +68,47 @@ size_t InputVirtual::getNumberAxes()
 
 bool InputVirtual::isAnyButtonPressed()
 {
-	for (size_t j=0; j < buttons.size(); j++) {
-		auto& binds = buttons[j];
-		for (size_t i=0; i<binds.size(); i++) {
-			Bind& bind = binds[i];
-			if (bind.device->isAnyButtonPressed()) {
-				return true;
-			}
-		}
-	}
-	return false;
+	refreshIfStale();
+	return (anyButtonState & ButtonPressed) != 0;
 }
 
 bool InputVirtual::isAnyButtonReleased()
 {
-	for (size_t j=0; j < buttons.size(); j++) {
-		auto& binds = buttons[j];
-		for (size_t i=0; i<binds.size(); i++) {
-			Bind& bind = binds[i];
-			if (bind.device->isAnyButtonReleased()) {
-				return true;
-			}
-		}
-	}
-	return false;
+	refreshIfStale();
+	return (anyButtonState & ButtonReleased) != 0;
 }
 
 bool InputVirtual::isAnyButtonDown()
 {
-	for (size_t j=0; j < buttons.size(); j++) {
-		auto& binds = buttons[j];
-		for (size_t i=0; i<binds.size(); i++) {
-			Bind& bind = binds[i];
-			if (bind.device->isAnyButtonDown()) {
-				return true;
-			}
-		}
-	}
-	return false;
+	refreshIfStale();
+	return (anyButtonState & ButtonDown) != 0;
 }
 
 bool InputVirtual::isButtonPressed(int code)
 {
-	auto& binds = buttons.at(code);
-	for (size_t i=0; i<binds.size(); i++) {
-		Bind& bind = binds[i];
-		if (bind.device->isButtonPressed(bind.a)) {
-			return true;
-		}
-	}
-	return false;
+	refreshIfStale();
+	return (buttonStates.at(code) & ButtonPressed) != 0;
 }
 
 bool InputVirtual::isButtonPressedRepeat(int code)
 {
-	auto& binds = buttons.at(code);
-	for (size_t i=0; i<binds.size(); i++) {
-		Bind& bind = binds[i];
-		if (bind.device->isButtonPressedRepeat(bind.a)) {
-			return true;
-		}
-	}
-	return false;
+	refreshIfStale();
+	return (buttonStates.at(code) & ButtonPressedRepeat) != 0;
 }
 
 bool InputVirtual::isButtonReleased(int code)
 {
-	auto& binds = buttons.at(code);
-	for (size_t i=0; i<binds.size(); i++) {
-		Bind& bind = binds[i];
-		if (bind.device->isButtonReleased(bind.a)) {
-			return true;
-		}
-	}
-	return false;
+	refreshIfStale();
+	return (buttonStates.at(code) & ButtonReleased) != 0;
 }
 
 bool InputVirtual::isButtonDown(int code)
 {
-	auto& binds = buttons.at(code);
-	for (size_t i=0; i<binds.size(); i++) {
-		Bind& bind = binds[i];
-		if (bind.device->isButtonDown(bind.a)) {
-			return true;
-		}
-	}
-	return false;
+	refreshIfStale();
+	return (buttonStates.at(code) & ButtonDown) != 0;
 }
 
+// Clearing changes the state of the underlying devices, which will be picked up on the next query
 void InputVirtual::clearButton(int code)
 {
 	auto& binds = buttons.at(code);
@@ -184,21 +138,8 @@ void InputVirtual::clearButtonRelease(int code)
 
 float InputVirtual::getAxis(int n)
 {
-	auto& binds = axes.at(n).binds;
-	float value = 0;
-
-	for (size_t i=0; i<binds.size(); i++) {
-		Bind& b = binds[i];
-		if (b.isAxisEmulation) {
-			int left = b.device->isButtonDown(b.a) ? 1 : 0;
-			int right = b.device->isButtonDown(b.b) ? 1 : 0;
-			value += right - left;
-		} else {
-			value += b.device->getAxis(b.a);
-		}
-	}
-
-	return value;
+	refreshIfStale();
+	return axisValues.at(n);
 }
 
 int InputVirtual::getAxisRepeat(int n)
@@ -212,6 +153,7 @@ void InputVirtual::bindButton(int n, spInputDevice device, int deviceN)
 		setLastDevice(device.get());
 	}
 	buttons.at(n).push_back(Bind(device, deviceN, false));
+	onBindingsChanged();
 }
 
 void InputVirtual::bindAxis(int n, spInputDevice device, int deviceN)
@@ -220,6 +162,7 @@ void InputVirtual::bindAxis(int n, spInputDevice device, int deviceN)
 		setLastDevice(device.get());
 	}
 	axes.at(n).binds.push_back(Bind(device, deviceN, true));
+	onBindingsChanged();
 }
 
 void InputVirtual::bindAxisButton(int n, spInputDevice device, int negativeButton, int positiveButton)
@@ -228,6 +171,7 @@ void InputVirtual::bindAxisButton(int n, spInputDevice device, int negativeButto
 		setLastDevice(device.get());
 	}
 	axes.at(n).binds.push_back(Bind(device, negativeButton, positiveButton, true));
+	onBindingsChanged();
 }
 
 void InputVirtual::bindVibrationOverride(spInputDevice joy)
@@ -238,11 +182,13 @@ void InputVirtual::bindVibrationOverride(spInputDevice joy)
 void InputVirtual::unbindButton(int n)
 {
 	buttons.at(n).clear();
+	onBindingsChanged();
 }
 
 void InputVirtual::unbindAxis(int n)
 {
 	axes.at(n).binds.clear();
+	onBindingsChanged();
 }
 
 void InputVirtual::clearBindings()
@@ -254,6 +200,7 @@ void InputVirtual::clearBindings()
 		axes[i].binds.clear();
 	}
 	vibrationOverride = spInputDevice();
+	onBindingsChanged();
 }
 
 void InputVirtual::vibrate(spInputVibration vib)
@@ -335,14 +282,17 @@ String InputVirtual::getButtonName(int code)
 
 void InputVirtual::update(Time t)
 {
-	updateLastDevice();
+	const auto newLastDevice = sampleDevices();
+	if (newLastDevice && !lastDeviceFrozen) {
+		setLastDevice(newLastDevice);
+	}
 
 	for (size_t i = 0; i < axes.size(); i++) {
 		auto& axis = axes[i];
 
 		axis.curRepeatValue = 0;
 
-		float curVal = getAxis(int(i));
+		float curVal = axisValues[i];
 		int intVal = curVal > 0.50f ? 1 : (curVal < -0.50f ? -1 : 0);
 
 		auto& timeSinceRepeat = axis.timeSinceRepeat;
@@ -388,32 +338,127 @@ InputDevice* InputVirtual::getLastDevice() const
 	return lastDevice;
 }
 
-void InputVirtual::updateLastDevice()
-{
-	if (!lastDeviceFrozen) {
-		for (auto& buttonBinds: buttons) {
-			for (auto& bind: buttonBinds) {
-				if (bind.device && !std::dynamic_pointer_cast<InputManual>(bind.device)) {
-					if (!bind.isAxisEmulation && bind.device->isButtonPressed(bind.a)) {
-						setLastDevice(bind.device.get());
-						return;
-					}
-				}
+void InputVirtual::onBindingsChanged()
+{
+	compiledButtonBinds.clear();
+	compiledAxisBinds.clear();
+	buttonDevices.clear();
+	allDevices.clear();
+
+	auto compile = [] (const Bind& bind, int index) -> CompiledBind
+	{
+		CompiledBind result;
+		result.device = bind.device.get();
+		result.index = index;
+		result.a = bind.a;
+		result.b = bind.b;
+		result.isAxisEmulation = bind.isAxisEmulation;
+		result.isManual = std::dynamic_pointer_cast<InputManual>(bind.device) != nullptr;
+		return result;
+	};
+
+	auto addDevice = [] (Vector<InputDevice*>& devices, InputDevice* device)
+	{
+		if (std::find(devices.begin(), devices.end(), device) == devices.end()) {
+			devices.push_back(device);
+		}
+	};
+
+	for (size_t i = 0; i < buttons.size(); ++i) {
+		for (auto& bind: buttons[i]) {
+			if (bind.device) {
+				compiledButtonBinds.push_back(compile(bind, int(i)));
+				addDevice(buttonDevices, bind.device.get());
+				addDevice(allDevices, bind.device.get());
 			}
 		}
-		for (auto& axisBind: axes) {
-			for (auto& bind: axisBind.binds) {
-				if (bind.device && !std::dynamic_pointer_cast<InputManual>(bind.device)) {
-					if ((!bind.isAxisEmulation && fabs(bind.device->getAxis(bind.a)) > 0.1f)
-						|| (bind.isAxisEmulation && bind.device->isButtonDown(bind.a))
-						|| (bind.isAxisEmulation && bind.device->isButtonDown(bind.b))) {
-						setLastDevice(bind.device.get());
-						return;
-					}
-				}
+	}
+	for (size_t i = 0; i < axes.size(); ++i) {
+		for (auto& bind: axes[i].binds) {
+			if (bind.device) {
+				compiledAxisBinds.push_back(compile(bind, int(i)));
+				addDevice(allDevices, bind.device.get());
 			}
 		}
 	}
+
+	sampleDevices();
+}
+
+void InputVirtual::refreshIfStale()
+{
+	for (size_t i = 0; i < allDevices.size(); ++i) {
+		if (allDevices[i]->getStateVersion() != sampledVersions[i]) {
+			sampleDevices();
+			return;
+		}
+	}
+}
+
+uint32_t InputVirtual::getStateVersion() const
+{
+	uint32_t version = InputDevice::getStateVersion();
+	for (auto& d: allDevices) {
+		version = version * 31 + d->getStateVersion();
+	}
+	return version;
+}
+
+InputDevice* InputVirtual::sampleDevices()
+{
+	InputDevice* active = nullptr;
+
+	anyButtonState = 0;
+	for (auto& device: buttonDevices) {
+		anyButtonState |= (device->isAnyButtonDown() ? ButtonDown : 0)
+			| (device->isAnyButtonPressed() ? ButtonPressed : 0)
+			| (device->isAnyButtonReleased() ? ButtonReleased : 0);
+	}
+
+	std::fill(buttonStates.begin(), buttonStates.end(), uint8_t(0));
+	for (auto& bind: compiledButtonBinds) {
+		auto& device = *bind.device;
+		const uint8_t state = (device.isButtonDown(bind.a) ? ButtonDown : 0)
+			| (device.isButtonPressed(bind.a) ? ButtonPressed : 0)
+			| (device.isButtonPressedRepeat(bind.a) ? ButtonPressedRepeat : 0)
+			| (device.isButtonReleased(bind.a) ? ButtonReleased : 0);
+		buttonStates[bind.index] |= state;
+
+		if (!active && !bind.isManual && (state & ButtonPressed) != 0) {
+			active = bind.device;
+		}
+	}
+
+	std::fill(axisValues.begin(), axisValues.end(), 0.0f);
+	InputDevice* activeAxis = nullptr;
+	for (auto& bind: compiledAxisBinds) {
+		auto& device = *bind.device;
+		bool isActive;
+		if (bind.isAxisEmulation) {
+			const bool left = device.isButtonDown(bind.a);
+			const bool right = device.isButtonDown(bind.b);
+			axisValues[bind.index] += float((right ? 1 : 0) - (left ? 1 : 0));
+			isActive = left || right;
+		} else {
+			const float value = device.getAxis(bind.a);
+			axisValues[bind.index] += value;
+			isActive = fabs(value) > 0.1f;
+		}
+
+		if (!activeAxis && !bind.isManual && isActive) {
+			activeAxis = bind.device;
+		}
+	}
+
+	// Recorded after reading, as reading a nested InputVirtual may resample it and change its version
+	sampledVersions.resize(allDevices.size());
+	for (size_t i = 0; i < allDevices.size(); ++i) {
+		sampledVersions[i] = allDevices[i]->getStateVersion();
+	}
+	notifyStateChanged();
+
+	// Buttons take priority over axes
+	return active ? active : activeAxis;
 }
 
 InputVirtual::Bind::Bind(spInputDevice d, int n, bool axis)
@@ -454,28 +499,6 @@ InputVirtual::PositionBindData::PositionBindData(spInputDevice device, int axisX
 	, speed(speed)
 {}
 
-std::set<spInputDevice> InputVirtual::getAllDevices() const
-{
-	std::set<spInputDevice> devices;
-
-	for (auto& axisBind: axes) {
-		for (auto& bind: axisBind.binds) {
-			if (bind.device) {
-				devices.insert(bind.device);
-			}
-		}
-	}
-	for (auto& buttonBinds: buttons) {
-		for (auto& bind: buttonBinds) {
-			if (bind.device) {
-				devices.insert(bind.device);
-			}
-		}
-	}
-
-	return devices;
-}
-
 void InputVirtual::setLastDeviceFreeze(bool frozen)
 {
 	lastDeviceFrozen = frozen;
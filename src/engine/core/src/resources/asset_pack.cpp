@@ -16,6 +16,22 @@ void AssetPackHeader::init(size_t assetDbSize)
 	memset(iv.data(), 0, iv.size());
 }
 
+// "HALLEYPK" packs are either plain or CBC encrypted as a whole; "HALLEYPC" packs are CTR encrypted, and can be decrypted in any range
+bool AssetPackHeader::isValid() const
+{
+	return memcmp(identifier.data(), "HALLEYPK", 8) == 0 || isSeekableEncryption();
+}
+
+bool AssetPackHeader::isSeekableEncryption() const
+{
+	return memcmp(identifier.data(), "HALLEYPC", 8) == 0;
+}
+
+void AssetPackHeader::setSeekableEncryption()
+{
+	memcpy(identifier.data(), "HALLEYPC", 8);
+}
+
 AssetPack::AssetPack()
 	: assetDb(std::make_unique<AssetDatabase>())
 	, hasReader(false)
@@ -42,10 +58,11 @@ AssetPack::AssetPack(std::unique_ptr<ResourceDataReader> _reader, const String&
 	if (nRead != int(sizeof(header))) {
 		throw Exception("Unable to read header", HalleyExceptions::Resources);
 	}
-	if (memcmp(header.identifier.data(), "HALLEYPK", 8) != 0) {
+	if (!header.isValid()) {
 		throw Exception("Asset pack is invalid (invalid identifier)", HalleyExceptions::Resources);
 	}
 	iv = header.iv;
+	seekableEncryption = header.isSeekableEncryption();
 	dataOffset = size_t(header.dataStartPos);
 
 	// Read asset database
@@ -64,12 +81,17 @@ AssetPack::AssetPack(std::unique_ptr<ResourceDataReader> _reader, const String&
 	memset(ivEmpty.data(), 0, ivEmpty.size());
 	const bool hasCrypt = memcmp(iv.data(), ivEmpty.data(), iv.size()) != 0 && !encryptionKey.isEmpty();
 
-	if (preLoad || hasCrypt) {
-		readToMemory();
-	}
+	if (hasCrypt && seekableEncryption && !preLoad) {
+		// Decrypt each read as it happens, so the pack can still be streamed
+		cipher = std::make_unique<Encrypt::CTRCipher>(getIV(), encryptionKey);
+	} else {
+		if (preLoad || hasCrypt) {
+			readToMemory();
+		}
 
-	if (hasCrypt) {
-		decrypt(encryptionKey);
+		if (hasCrypt) {
+			decrypt(encryptionKey);
+		}
 	}
 }
 
@@ -85,6 +107,9 @@ AssetPack& AssetPack::operator=(AssetPack&& other)
 	dataOffset = other.dataOffset;
 	reader = std::move(other.reader);
 	data = std::move(other.data);
+	iv = other.iv;
+	seekableEncryption = other.seekableEncryption;
+	cipher = std::move(other.cipher);
 	hasReader = !!reader;
 
 	other.hasReader = false;
@@ -119,6 +144,9 @@ Bytes AssetPack::writeOut() const
 	AssetPackHeader header;
 	header.init(assetDbBytes.size());
 	header.iv = iv;
+	if (seekableEncryption) {
+		header.setSeekableEncryption();
+	}
 
 	auto result = Bytes(size_t(header.dataStartPos + data.size()));
 	memcpy(result.data(), &header, sizeof(AssetPackHeader));
@@ -127,12 +155,23 @@ Bytes AssetPack::writeOut() const
 	return result;
 }
 
+std::pair<size_t, size_t> AssetPack::getAssetRange(const String& asset, AssetType type) const
+{
+	auto ps = assetDb->getDatabase(type).get(asset).path.split(':');
+	return { size_t(ps.at(0).toInteger()), size_t(ps.at(1).toInteger()) };
+}
+
+String AssetPack::getPrefetchKey(const String& asset, AssetType type)
+{
+	return toString(int(type)) + ":" + asset;
+}
+
 std::unique_ptr<ResourceData> AssetPack::getData(const String& asset, AssetType type, bool stream)
 {
 	auto path = asset;
-	auto ps = assetDb->getDatabase(type).get(asset).path.split(':');
-	size_t pos = size_t(ps.at(0).toInteger());
-	size_t size = size_t(ps.at(1).toInteger());
+	const auto range = getAssetRange(asset, type);
+	const size_t pos = range.first;
+	const size_t size = range.second;
 
 	if (stream) {
 		return std::make_unique<ResourceDataStream>(path, [=] () -> std::unique_ptr<ResourceDataReader> {
@@ -140,6 +179,18 @@ std::unique_ptr<ResourceData> AssetPack::getData(const String& asset, AssetType
 		});
 	} else {
 		if (hasReader) {
+			{
+				// Already read ahead by prefetch()?
+				std::unique_lock<std::mutex> lock(prefetchMutex);
+				auto iter = prefetched.find(getPrefetchKey(asset, type));
+				if (iter != prefetched.end()) {
+					auto result = std::move(iter->second);
+					prefetched.erase(iter);
+					prefetchedBytes -= size;
+					return std::move(result);
+				}
+			}
+
 			auto result = new char[size];
 			try {
 				readData(pos, gsl::as_writeable_bytes(gsl::span<char>(result, size)));
@@ -159,6 +210,41 @@ std::unique_ptr<ResourceData> AssetPack::getData(const String& asset, AssetType
 	}
 }
 
+void AssetPack::prefetch(const String& asset, AssetType type)
+{
+	if (!hasReader) {
+		// Everything is already in memory
+		return;
+	}
+
+	const auto range = getAssetRange(asset, type);
+	const size_t pos = range.first;
+	const size_t size = range.second;
+	const auto key = getPrefetchKey(asset, type);
+
+	{
+		std::unique_lock<std::mutex> lock(prefetchMutex);
+		if (prefetchedBytes + size > maxPrefetchBytes || prefetched.find(key) != prefetched.end()) {
+			return;
+		}
+	}
+
+	auto buffer = new char[size];
+	try {
+		readData(pos, gsl::as_writeable_bytes(gsl::span<char>(buffer, size)));
+	} catch (...) {
+		delete[] buffer;
+		throw;
+	}
+	auto result = std::make_unique<ResourceDataStatic>(buffer, size, asset, true);
+
+	std::unique_lock<std::mutex> lock(prefetchMutex);
+	if (prefetched.find(key) == prefetched.end()) {
+		prefetched[key] = std::move(result);
+		prefetchedBytes += size;
+	}
+}
+
 void AssetPack::readToMemory()
 {
 	std::unique_lock<std::mutex> lock(readerMutex);
@@ -166,24 +252,36 @@ void AssetPack::readToMemory()
 	data = reader->readAll();
 	hasReader = false;
 	reader.reset();
+
+	if (cipher) {
+		cipher->apply(0, gsl::as_writeable_bytes(gsl::span<Byte>(data)));
+		cipher.reset();
+	}
 }
 
 void AssetPack::encrypt(const String& key)
 {
 	// Generate IV
-	Random::getGlobal().getBytes(gsl::as_writeable_bytes(gsl::span<char>(iv)));
-	Bytes ivBytes(iv.size());
-	memcpy(ivBytes.data(), iv.data(), iv.size());
+	Random::getThreadLocal().getBytes(gsl::as_writeable_bytes(gsl::span<char>(iv)));
 
-	data = Encrypt::encrypt(ivBytes, key, data);
+	seekableEncryption = true;
+	Encrypt::CTRCipher(getIV(), key).apply(0, gsl::as_writeable_bytes(gsl::span<Byte>(data)));
 }
 
 void AssetPack::decrypt(const String& key)
+{
+	if (seekableEncryption) {
+		Encrypt::CTRCipher(getIV(), key).apply(0, gsl::as_writeable_bytes(gsl::span<Byte>(data)));
+	} else {
+		data = Encrypt::decrypt(getIV(), key, data);
+	}
+}
+
+Bytes AssetPack::getIV() const
 {
 	Bytes ivBytes(iv.size());
 	memcpy(ivBytes.data(), iv.data(), iv.size());
-
-	data = Encrypt::decrypt(ivBytes, key, data);
+	return ivBytes;
 }
 
 void AssetPack::readData(size_t pos, gsl::span<gsl::byte> dst)
@@ -193,6 +291,11 @@ void AssetPack::readData(size_t pos, gsl::span<gsl::byte> dst)
 		if (reader) {
 			reader->seek(pos + dataOffset, SEEK_SET);
 			reader->read(dst);
+			lock.unlock();
+
+			if (cipher) {
+				cipher->apply(pos, dst);
+			}
 			return;
 		}
 	}
@@ -208,6 +311,7 @@ std::unique_ptr<ResourceDataReader> AssetPack::extractReader()
 {
 	std::unique_lock<std::mutex> lock(readerMutex);
 	hasReader = false;
+	cipher.reset();
 	return std::move(reader);
 }
 
@@ -0,0 +1,39 @@
+#include "resources/prefetch_manifest.h"
+#include "halley/bytes/byte_serializer.h"
+#include "halley/resources/resource.h"
+
+using namespace Halley;
+
+void PrefetchManifest::Entry::serialize(Serializer& s) const
+{
+	s << type;
+	s << assetId;
+	s << time;
+}
+
+void PrefetchManifest::Entry::deserialize(Deserializer& s)
+{
+	s >> type;
+	s >> assetId;
+	s >> time;
+}
+
+void PrefetchManifest::add(AssetType type, const String& assetId, float time)
+{
+	entries.push_back(Entry{ type, assetId, time });
+}
+
+const std::vector<PrefetchManifest::Entry>& PrefetchManifest::getEntries() const
+{
+	return entries;
+}
+
+void PrefetchManifest::serialize(Serializer& s) const
+{
+	s << entries;
+}
+
+void PrefetchManifest::deserialize(Deserializer& s)
+{
+	s >> entries;
+}
@@ -3,6 +3,7 @@
 #include "resources/resources.h"
 #include <halley/resources/resource.h>
 #include "halley/support/logger.h"
+#include "halley/support/memory_tracker.h"
 
 using namespace Halley;
 
@@ -10,6 +11,7 @@ using namespace Halley;
 ResourceCollectionBase::ResourceCollectionBase(Resources& parent, AssetType type)
 	: parent(parent)
 	, type(type)
+	, loadsStat(Stats::get("resources.loads"))
 {
 }
 
@@ -69,6 +71,7 @@ std::vector<String> ResourceCollectionBase::enumerate() const
 }
 
 std::shared_ptr<Resource> ResourceCollectionBase::loadAsset(const String& assetId, ResourceLoadPriority priority) {
+	MemoryTagScope memTag(MemoryTag::Resources);
 	std::shared_ptr<Resource> newRes;
 
 	if (resourceLoader) {
@@ -86,6 +89,7 @@ std::shared_ptr<Resource> ResourceCollectionBase::loadAsset(const String& assetI
 	if (!newRes) {
 		throw Exception("Unable to load resource data: " + assetId, HalleyExceptions::Resources);
 	}
+	loadsStat.add();
 	return newRes;
 }
 
@@ -98,6 +102,7 @@ std::shared_ptr<Resource> ResourceCollectionBase::doGet(const String& assetId, R
 	}
 	
 	// Load resource from disk
+	parent.onFirstAccess(type, assetId);
 	std::shared_ptr<Resource> newRes = loadAsset(assetId, priority);
 
 	// Store in cache
@@ -77,6 +77,14 @@ void ResourceLocator::purge(const String& asset, AssetType type)
 	}
 }
 
+void ResourceLocator::prefetch(const String& asset, AssetType type)
+{
+	auto result = locators.find(asset);
+	if (result != locators.end()) {
+		result->second->prefetch(asset, type);
+	}
+}
+
 std::vector<String> ResourceLocator::enumerate(const AssetType type)
 {
 	std::vector<String> result;
@@ -9,7 +9,7 @@ PackResourceLocator::PackResourceLocator(std::unique_ptr<ResourceDataReader> rea
 	, encryptionKey(std::move(key))
 	, preLoad(preLoad)
 {
-	assetPack = std::make_unique<AssetPack>(std::move(reader), encryptionKey, preLoad);
+	assetPack = std::make_shared<AssetPack>(std::move(reader), encryptionKey, preLoad);
 }
 
 PackResourceLocator::~PackResourceLocator()
@@ -18,27 +18,46 @@ PackResourceLocator::~PackResourceLocator()
 
 std::unique_ptr<ResourceData> PackResourceLocator::getData(const String& asset, AssetType type, bool stream)
 {
-	if (!assetPack) {
-		loadAfterPurge();
-	}
-	return assetPack->getData(asset, type, stream);
+	return getAssetPack()->getData(asset, type, stream);
 }
 
 const AssetDatabase& PackResourceLocator::getAssetDatabase()
 {
-	if (!assetPack) {
-		loadAfterPurge();
-	}
-	return assetPack->getAssetDatabase();
+	return getAssetPack()->getAssetDatabase();
 }
 
 void PackResourceLocator::purge(SystemAPI& sys)
 {
+	std::unique_lock<std::mutex> lock(mutex);
 	assetPack.reset();
 	system = &sys;
 }
 
+void PackResourceLocator::prefetch(const String& asset, AssetType type)
+{
+	// Called from the disk IO thread. Hold on to the pack rather than the lock, so a purge in the meantime doesn't pull it from under us,
+	// and loads on other threads aren't held up by the read.
+	std::shared_ptr<AssetPack> pack;
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		pack = assetPack;
+	}
+	if (pack) {
+		pack->prefetch(asset, type);
+	}
+}
+
+std::shared_ptr<AssetPack> PackResourceLocator::getAssetPack()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	if (!assetPack) {
+		loadAfterPurge();
+	}
+	return assetPack;
+}
+
 void PackResourceLocator::loadAfterPurge()
 {
-	assetPack = std::make_unique<AssetPack>(system->getDataReader(path.string()), encryptionKey, preLoad);
+	// Mutex must be held
+	assetPack = std::make_shared<AssetPack>(system->getDataReader(path.string()), encryptionKey, preLoad);
 }
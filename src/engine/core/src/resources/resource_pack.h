@@ -1,5 +1,7 @@
 #pragma once
 
+#include <memory>
+#include <mutex>
 #include "resources/resource_locator.h"
 #include "resources/asset_database.h"
 
@@ -16,11 +18,14 @@ namespace Halley {
 		std::unique_ptr<ResourceData> getData(const String& asset, AssetType type, bool stream) override;
 		const AssetDatabase& getAssetDatabase() override;
 		void purge(SystemAPI& system) override;
+		void prefetch(const String& asset, AssetType type) override;
 
 	private:
+		std::shared_ptr<AssetPack> getAssetPack();
 		void loadAfterPurge();
 
-		std::unique_ptr<AssetPack> assetPack;
+		std::mutex mutex;
+		std::shared_ptr<AssetPack> assetPack; // Guarded by mutex, as prefetch runs on the disk IO thread
 
 		Path path;
 		String encryptionKey; // :(
@@ -1,12 +1,84 @@
 #include "resources/resources.h"
 #include "resources/resource_locator.h"
 #include "api/halley_api.h"
+#include "halley/concurrency/concurrent.h"
+#include "halley/support/logger.h"
 
 using namespace Halley;
 
 Resources::Resources(std::unique_ptr<ResourceLocator> locator, const HalleyAPI* api)
 	: locator(std::move(locator))
 	, api(api)
+	, prefetchState(std::make_shared<PrefetchState>())
 {}
 
-Resources::~Resources() = default;
+Resources::~Resources()
+{
+	// Tasks still in the queue will bail out when they see this; only wait for the ones already reading through the locator
+	std::unique_lock<std::mutex> lock(prefetchState->mutex);
+	prefetchState->cancelled = true;
+	prefetchState->finished.wait(lock, [&] () { return prefetchState->running == 0; });
+}
+
+void Resources::startRecordingAccesses()
+{
+	std::unique_lock<std::mutex> lock(recordingMutex);
+	recording = std::make_unique<PrefetchManifest>();
+	recordingStart = std::chrono::steady_clock::now();
+}
+
+PrefetchManifest Resources::stopRecordingAccesses()
+{
+	std::unique_lock<std::mutex> lock(recordingMutex);
+	PrefetchManifest result;
+	if (recording) {
+		result = std::move(*recording);
+		recording.reset();
+	}
+	return result;
+}
+
+void Resources::prefetch(const PrefetchManifest& manifest)
+{
+	ResourceLocator* loc = locator.get();
+	auto state = prefetchState;
+	auto entries = manifest.getEntries();
+	Concurrent::execute(Executors::getDiskIO(), [loc, state, entries = std::move(entries)] ()
+	{
+		{
+			std::unique_lock<std::mutex> lock(state->mutex);
+			if (state->cancelled) {
+				return;
+			}
+			++state->running;
+		}
+
+		for (auto& e: entries) {
+			{
+				std::unique_lock<std::mutex> lock(state->mutex);
+				if (state->cancelled) {
+					break;
+				}
+			}
+
+			try {
+				loc->prefetch(e.assetId, e.type);
+			} catch (std::exception& ex) {
+				Logger::logWarning("Unable to prefetch \"" + e.assetId + "\": " + ex.what());
+			}
+		}
+
+		std::unique_lock<std::mutex> lock(state->mutex);
+		--state->running;
+		state->finished.notify_all();
+	});
+}
+
+void Resources::onFirstAccess(AssetType type, const String& assetId)
+{
+	std::unique_lock<std::mutex> lock(recordingMutex);
+	if (recording) {
+		const float time = std::chrono::duration<float>(std::chrono::steady_clock::now() - recordingStart).count();
+		recording->add(type, assetId, time);
+	}
+}
@@ -6,6 +6,7 @@
 #include <halley/entity/world.h>
 #include <halley/entity/system.h>
 #include "halley/text/string_converter.h"
+#include "halley/support/stats.h"
 
 using namespace Halley;
 
@@ -22,6 +23,8 @@ void WorldStatsView::draw(RenderContext& context)
 
 		TimeLine timelines[] = { TimeLine::FixedUpdate, TimeLine::VariableUpdate, TimeLine::Render };
 		String timelineLabels[] = { "Fixed", "Variable", "Render" };
+		String timelineStats[] = { "frame.fixedNs", "frame.variableNs", "frame.renderNs" };
+		const auto stats = Stats::getInstance();
 		int i = 0;
 		float width = (float(context.getCamera().getActiveViewPort().getWidth()) - 40.0f) / 3.0f;
 
@@ -74,6 +77,28 @@ void WorldStatsView::draw(RenderContext& context)
 			drawStats("[Engine]", 0, total - gameTotal - vsyncTime, pos);
 			text.setColour(Colour(0.8f, 1.0f, 0.8f));
 			drawStats("Total", world ? int(world->numEntities()) : 0, total, pos);
+
+			if (stats) {
+				// Averages hide spikes, so show the tail of the engine frame time too
+				const auto summary = stats->getSummary(timelineStats[int(timeline)]);
+				text
+					.setColour(Colour(1.0f, 0.8f, 0.5f))
+					.setText("p50 / p95 / p99: " + formatTime(summary.p50) + " / " + formatTime(summary.p95) + " / " + formatTime(summary.p99))
+					.setPosition(pos + Vector2f(10, 0))
+					.draw(painter);
+				pos.y += 20;
+			}
+		}
+
+		if (stats) {
+			String counters;
+			for (auto& summary: stats->getSummaries()) {
+				if (summary.kind == StatKind::Counter) {
+					counters += summary.name + ": " + toString(summary.latest) + " (max " + toString(summary.max) + ")   ";
+				}
+			}
+			const float bottom = float(context.getCamera().getActiveViewPort().getHeight()) - 30.0f;
+			text.setColour(Colour(0.8f, 0.8f, 1.0f)).setText(counters).setPosition(Vector2f(20, bottom)).draw(painter);
 		}
 
 		int maxFPS = int(lround(1'000'000'000.0 / grandTotal));
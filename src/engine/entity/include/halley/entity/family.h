@@ -40,14 +40,23 @@ namespace Halley {
 		void notifyRemove(void* entities, size_t count);
 
 	protected:
-		virtual void addEntity(Entity& entity) = 0;
+		void addEntity(Entity& entity);
 		void removeEntity(Entity& entity);
+		bool hasPendingChanges() const;
+
+		// Applies the queued additions and removals. Families don't share any state, so World runs this on several
+		// families in parallel; it must not invoke bindings or touch anything outside the family.
 		virtual void updateEntities() = 0;
+
+		// Invokes the bindings for the changes applied by the last updateEntities(), removals first. Called on the
+		// world's thread, one family at a time in creation order.
+		virtual void notifyEntityChanges() = 0;
 		virtual void clearEntities() = 0;
 		
 		void* elems = nullptr;
 		size_t elemCount = 0;
 		size_t elemSize = 0;
+		Vector<Entity*> toAdd;
 		Vector<EntityId> toRemove;
 
 		Vector<FamilyBindingBase*> addEntityCallbacks;
@@ -103,46 +112,43 @@ namespace Halley {
 		FamilyImpl() : Family(T::Type::inclusionMask()) {}
 				
 	protected:
-		void addEntity(Entity& entity) override
+		void updateEntities() override
 		{
-			entities.push_back(StorageType());
-			auto& e = entities.back();
-			e.entityId = entity.getEntityId();
-			T::Type::loadComponents(entity, &e.data[0]);
-
-			dirty = true;
+			removeDeadEntities();
+			addNewEntities();
+			updateElems();
 		}
 
-		void updateEntities() override
+		void notifyEntityChanges() override
 		{
-			if (dirty) {
-				// Notify additions
+			if (!removed.empty()) {
 				HALLEY_DEBUG_TRACE();
-				size_t prevSize = elemCount;
-				size_t curSize = entities.size();
-				updateElems();
-				Expects(curSize >= prevSize);
-				if (curSize > prevSize) {
-					notifyAdd(entities.data() + prevSize, curSize - prevSize);
-				}
-
-				dirty = false;
+				notifyRemove(removed.data(), removed.size());
+				removed.clear();
 			}
 
-			// Remove
-			removeDeadEntities();
+			if (numAdded > 0) {
+				HALLEY_DEBUG_TRACE();
+				notifyAdd(entities.data() + entities.size() - numAdded, numAdded);
+				numAdded = 0;
+			}
 		}
 
 		void clearEntities() override
 		{
 			notifyRemove(entities.data(), entities.size());
 			entities.clear();
+			removed.clear();
+			toAdd.clear();
+			toRemove.clear();
+			numAdded = 0;
 			updateElems();
 		}
 
 	private:
 		Vector<StorageType> entities;
-		bool dirty = false;
+		Vector<StorageType> removed; // Kept alive until the removal has been notified
+		size_t numAdded = 0;
 
 		void updateElems()
 		{
@@ -151,15 +157,39 @@ namespace Halley {
 			elemSize = sizeof(StorageType);
 		}
 
+		void addNewEntities()
+		{
+			// Anything still in toRemove at this point was queued for addition in this same update, so it's dropped here
+			if (!toRemove.empty()) {
+				toAdd.erase(std::remove_if(toAdd.begin(), toAdd.end(), [&] (Entity* e)
+				{
+					auto iter = std::lower_bound(toRemove.begin(), toRemove.end(), e->getEntityId());
+					if (iter != toRemove.end() && *iter == e->getEntityId()) {
+						toRemove.erase(iter);
+						return true;
+					}
+					return false;
+				}), toAdd.end());
+				Expects(toRemove.empty());
+			}
+
+			for (auto* entity: toAdd) {
+				entities.push_back(StorageType());
+				auto& e = entities.back();
+				e.entityId = entity->getEntityId();
+				T::Type::loadComponents(*entity, &e.data[0]);
+			}
+
+			// Added entities are always at the back, as removal already happened
+			numAdded += toAdd.size();
+			toAdd.clear();
+		}
+
 		void removeDeadEntities()
 		{
 			// Performance-critical code
 			// Benchmarks suggest that using a Vector is faster than std::set and std::unordered_set
 			if (!toRemove.empty()) {
-				HALLEY_DEBUG_TRACE();
-				size_t removeCount = toRemove.size();
-				Expects(removeCount > 0);
-				Expects(removeCount <= entities.size());
 				std::sort(toRemove.begin(), toRemove.end());
 
 				for (size_t i = 1; i < toRemove.size(); ++i) {
@@ -167,40 +197,32 @@ namespace Halley {
 				}
 
 				// Move all entities to be removed to the back of the vector
-				{
-					int n = int(entities.size());
-					// Note: it's important to scan it forward. Scanning backwards would improve performance for short-lived entities,
-					// but it causes an issue where an entity is removed and added to the same family in one frame.
-					for (int i = 0; i < n; i++) {
-						EntityId id = entities[i].entityId;
-						auto iter = std::lower_bound(toRemove.begin(), toRemove.end(), id);
-						if (iter != toRemove.end() && id == *iter) {
-							toRemove.erase(iter);
-							if (i != n - 1) {
-								std::swap(entities[i], entities[n - 1]);
-								i--;
-							}
-							n--;
-							if (toRemove.empty()) {
-								break;
-							}
+				// Removals run before additions, so an entity that is removed and re-added to the same family in one update
+				// has its old entry removed here, and ids that aren't found yet were only queued for addition.
+				int n = int(entities.size());
+				for (int i = 0; i < n; i++) {
+					EntityId id = entities[i].entityId;
+					auto iter = std::lower_bound(toRemove.begin(), toRemove.end(), id);
+					if (iter != toRemove.end() && id == *iter) {
+						toRemove.erase(iter);
+						if (i != n - 1) {
+							std::swap(entities[i], entities[n - 1]);
+							i--;
+						}
+						n--;
+						if (toRemove.empty()) {
+							break;
 						}
 					}
-					Ensures(size_t(n) + removeCount == entities.size());
 				}
 
-				Expects(toRemove.empty());
-
-				// Notify removal
-				size_t newSize = entities.size() - removeCount;
-				Ensures(newSize < entities.size());
-				notifyRemove(entities.data() + newSize, removeCount);
-
-				// Remove them
+				// Keep them until notifyEntityChanges()
+				const size_t newSize = size_t(n);
+				for (size_t i = newSize; i < entities.size(); ++i) {
+					removed.push_back(std::move(entities[i]));
+				}
 				entities.resize(newSize);
-				updateElems();
 			}
-			Ensures(toRemove.empty());
 		}
 	};
 }
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <functional>
+#include <cstdint>
+#include <halley/data_structures/maybe.h>
+
+namespace Halley {
+	class World;
+
+	// Runs deterministic worlds side by side, to catch code that makes simulations diverge
+	class LockstepHarness {
+	public:
+		using InputFunction = std::function<void(World& world, uint64_t tick)>;
+
+		// Both worlds must be set up identically and be in deterministic mode. Before each FixedUpdate step, inputs is
+		// called on each world for that tick. Returns the first tick where the state hashes differ, if any.
+		static Maybe<uint64_t> findFirstDesync(World& a, World& b, uint64_t numTicks, const InputFunction& inputs);
+	};
+}
@@ -9,6 +9,7 @@
 #include "family_type.h"
 #include "entity.h"
 #include "halley/utils/type_traits.h"
+#include "halley/utils/hash.h"
 
 namespace Halley {
 	class Message;
@@ -53,6 +54,10 @@ namespace Halley {
 		virtual void renderBase(RenderContext&) {}
 		virtual void onMessagesReceived(int, Message**, size_t*, size_t) {}
 
+		// In deterministic worlds, feed any simulation state owned by this system or its families (fixed point values,
+		// not floats) into the hasher. The result is compared across peers to detect desyncs.
+		virtual void hashState(Hash::Hasher&) const {}
+
 		template <typename F, typename V>
 		static void invokeIndividual(F&& f, V& fam)
 		{
@@ -10,6 +10,7 @@
 #include <halley/text/halleystring.h>
 #include <halley/data_structures/mapped_pool.h>
 #include <halley/time/stopwatch.h>
+#include <halley/support/stats.h>
 #include <halley/data_structures/vector.h>
 #include <halley/data_structures/tree_map.h>
 #include "service.h"
@@ -29,6 +30,19 @@ namespace Halley {
 		~World();
 
 		void step(TimeLine timeline, Time elapsed);
+
+		// Deterministic mode, for lockstep simulation. FixedUpdate steps always advance by timeStep, ignoring the elapsed
+		// time passed in, and each one increments the tick and computes a state hash, to compare against peers.
+		// Family iteration order is not creation order (removals swap the last entity into the gap), but it only depends
+		// on the sequence of additions and removals, so peers applying the same operations in the same order iterate
+		// identically. Messages are delivered sorted by target, so as long as systems on FixedUpdate only use
+		// Fixed/integer maths and seeded Random, every peer ends up in the same state.
+		// VariableUpdate and Render must not modify simulation state.
+		void setDeterministic(Time timeStep);
+		bool isDeterministic() const;
+		uint64_t getTick() const;
+		uint64_t getStateHash() const; // Hash computed at the end of the last FixedUpdate step
+		uint64_t computeStateHash() const;
 		void render(RenderContext& rc) const;
 		bool hasSystemsOnTimeLine(TimeLine timeline) const;
 		
@@ -85,6 +99,13 @@ namespace Halley {
 		const HalleyAPI* api;
 		std::array<Vector<std::unique_ptr<System>>, static_cast<int>(TimeLine::NUMBER_OF_TIMELINES)> systems;
 		bool collectMetrics = false;
+		StatHandle entitiesSpawnedStat;
+		StatHandle familyUpdateTimeStat;
+
+		bool deterministic = false;
+		Time deterministicTimeStep = 0;
+		uint64_t tick = 0;
+		uint64_t stateHash = 0;
 		bool entityDirty = false;
 		
 		Vector<Entity*> entities;
@@ -101,6 +122,7 @@ namespace Halley {
 
 		void allocateEntity(Entity* entity);
 		void updateEntities();
+		void updateFamilies();
 		void initSystems() const;
 		void deleteEntity(Entity* entity);
 
@@ -9,3 +9,4 @@ namespace Halley {} // Get GitHub to realise this is C++ :3
 #include "entity/world.h"
 #include "entity/family_binding.h"
 #include "entity/family.h"
+#include "entity/lockstep.h"
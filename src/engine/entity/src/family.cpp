@@ -42,7 +42,17 @@ void Family::notifyRemove(void* entities, size_t count)
 	}
 }
 
+void Family::addEntity(Entity& entity)
+{
+	toAdd.push_back(&entity);
+}
+
 void Family::removeEntity(Entity& entity)
 {
 	toRemove.push_back(entity.getEntityId());
 }
+
+bool Family::hasPendingChanges() const
+{
+	return !toAdd.empty() || !toRemove.empty();
+}
@@ -0,0 +1,29 @@
+#include "lockstep.h"
+#include "world.h"
+#include "halley/support/exception.h"
+
+using namespace Halley;
+
+Maybe<uint64_t> LockstepHarness::findFirstDesync(World& a, World& b, uint64_t numTicks, const InputFunction& inputs)
+{
+	if (!a.isDeterministic() || !b.isDeterministic()) {
+		throw Exception("Lockstep worlds must be in deterministic mode.", HalleyExceptions::Entity);
+	}
+	if (a.getStateHash() != b.getStateHash()) {
+		return a.getTick();
+	}
+
+	for (uint64_t i = 0; i < numTicks; ++i) {
+		for (auto* world: { &a, &b }) {
+			if (inputs) {
+				inputs(*world, world->getTick());
+			}
+			world->step(TimeLine::FixedUpdate, 0);
+		}
+		if (a.getStateHash() != b.getStateHash()) {
+			return a.getTick();
+		}
+	}
+
+	return {};
+}
@@ -1,6 +1,7 @@
 #include "system.h"
 #include <halley/data_structures/flat_map.h>
 #include "halley/support/debug.h"
+#include "world.h"
 
 using namespace Halley;
 
@@ -98,6 +99,13 @@ void System::doSendMessage(EntityId entityId, std::unique_ptr<Message> msg, size
 void System::dispatchMessages()
 {
 	if (!outbox.empty()) {
+		if (world->isDeterministic()) {
+			// Delivery order must not depend on the order in which parallel updates happened to send
+			std::stable_sort(outbox.begin(), outbox.end(), [] (const std::pair<EntityId, MessageEntry>& a, const std::pair<EntityId, MessageEntry>& b)
+			{
+				return a.first != b.first ? a.first < b.first : a.second.type < b.second.type;
+			});
+		}
 		for (auto& o: outbox) {
 			Entity* entity = world->tryGetEntity(o.first);
 			if (entity) {
@@ -8,6 +8,8 @@
 #include "family.h"
 #include "halley/text/string_converter.h"
 #include "halley/support/debug.h"
+#include "halley/support/memory_tracker.h"
+#include "halley/concurrency/concurrent.h"
 #include "halley/file_formats/config_file.h"
 
 using namespace Halley;
@@ -15,6 +17,8 @@ using namespace Halley;
 World::World(const HalleyAPI* api, bool collectMetrics)
 	: api(api)
 	, collectMetrics(collectMetrics)
+	, entitiesSpawnedStat(Stats::get("world.entitiesSpawned"))
+	, familyUpdateTimeStat(Stats::get("world.familyUpdateNs"))
 {	
 }
 
@@ -146,6 +150,7 @@ EntityRef World::createEntity()
 	}
 	entitiesPendingCreation.push_back(entity);
 	allocateEntity(entity);
+	entitiesSpawnedStat.add();
 	return EntityRef(*entity, *this);
 }
 
@@ -205,23 +210,73 @@ int64_t World::getAverageTime(TimeLine timeline) const
 
 void World::step(TimeLine timeline, Time elapsed)
 {
+	MemoryTagScope memTag(MemoryTag::World);
 	auto& t = timer[int(timeline)];
 	if (collectMetrics) {
 		t.beginSample();
 	}
 
+	const bool simulationTick = deterministic && timeline == TimeLine::FixedUpdate;
+	if (simulationTick) {
+		elapsed = deterministicTimeStep;
+	}
+
 	spawnPending();
 
 	initSystems();
 	updateSystems(timeline, elapsed);
 
+	if (simulationTick) {
+		++tick;
+		stateHash = computeStateHash();
+	}
+
 	if (collectMetrics) {
 		t.endSample();
 	}
 }
 
+void World::setDeterministic(Time timeStep)
+{
+	Expects(timeStep > 0);
+	deterministic = true;
+	deterministicTimeStep = timeStep;
+}
+
+bool World::isDeterministic() const
+{
+	return deterministic;
+}
+
+uint64_t World::getTick() const
+{
+	return tick;
+}
+
+uint64_t World::getStateHash() const
+{
+	return stateHash;
+}
+
+uint64_t World::computeStateHash() const
+{
+	Hash::Hasher hasher;
+	hasher.feed(tick);
+	hasher.feed(uint64_t(entities.size()));
+	for (auto& e: entities) {
+		hasher.feed(e->getEntityId().value);
+	}
+	for (auto& tl: systems) {
+		for (auto& system: tl) {
+			system->hashState(hasher);
+		}
+	}
+	return hasher.digest();
+}
+
 void World::render(RenderContext& rc) const
 {
+	MemoryTagScope memTag(MemoryTag::World);
 	auto& t = timer[int(TimeLine::Render)];
 	if (collectMetrics) {
 		t.beginSample();
@@ -317,10 +372,7 @@ void World::updateEntities()
 	}
 
 	HALLEY_DEBUG_TRACE();
-	// Update families
-	for (auto& iter : families) {
-		iter->updateEntities();
-	}
+	updateFamilies();
 
 	HALLEY_DEBUG_TRACE();
 	// Actually remove dead entities
@@ -344,6 +396,41 @@ void World::updateEntities()
 	HALLEY_DEBUG_TRACE();
 }
 
+void World::updateFamilies()
+{
+	Stopwatch timer;
+
+	Vector<Family*> dirtyFamilies;
+	size_t pendingChanges = 0;
+	for (auto& family: families) {
+		if (family->hasPendingChanges()) {
+			dirtyFamilies.push_back(family.get());
+			pendingChanges += family->toAdd.size() + family->toRemove.size();
+		}
+	}
+
+	// Families are independent, so apply their changes in parallel when there's enough work to pay for it
+	constexpr size_t minChangesForParallelUpdate = 512;
+	const bool parallel = dirtyFamilies.size() > 1 && pendingChanges >= minChangesForParallelUpdate && ExecutionQueue::getDefault().threadCount() > 0;
+	if (parallel) {
+		Concurrent::foreach(dirtyFamilies.begin(), dirtyFamilies.end(), [] (Family* family) {
+			family->updateEntities();
+		});
+	} else {
+		for (auto& family: dirtyFamilies) {
+			family->updateEntities();
+		}
+	}
+
+	// Bindings call into systems, so they're notified afterwards on this thread, in a fixed order
+	for (auto& family: dirtyFamilies) {
+		family->notifyEntityChanges();
+	}
+
+	timer.pause();
+	familyUpdateTimeStat.add(timer.elapsedNanoSeconds());
+}
+
 void World::initSystems() const
 {
 	for (auto& tl: systems) {
@@ -378,6 +465,7 @@ void World::onAddFamily(Family& family)
 		auto fMask = family.inclusionMask;
 		if ((eMask & fMask) == fMask) {
 			family.addEntity(entity);
+			entityDirty = true;
 		}
 	}
 	familyCache.clear();
@@ -7,6 +7,7 @@
 #include <chrono>
 #include <deque>
 #include <limits>
+#include <halley/support/stats.h>
 
 namespace Halley
 {
@@ -88,6 +89,9 @@ namespace Halley
 		Clock::time_point lastReceive;
 		Clock::time_point lastSend;
 
+		StatHandle packetsSentStat;
+		StatHandle bytesSentStat;
+
 		void processReceivedPacket(InboundNetworkPacket& packet);
 		unsigned int generateAckBits();
 
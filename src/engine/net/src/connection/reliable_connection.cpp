@@ -28,6 +28,8 @@ ReliableConnection::ReliableConnection(std::shared_ptr<IConnection> parent)
 	: parent(parent)
 	, receivedSeqs(BUFFER_SIZE)
 	, sentPackets(BUFFER_SIZE)
+	, packetsSentStat(Stats::get("net.packetsSent"))
+	, bytesSentStat(Stats::get("net.bytesSent"))
 {
 	lastSend = lastReceive = Clock::now();
 }
@@ -118,6 +120,8 @@ void ReliableConnection::sendTagged(gsl::span<ReliableSubPacket> subPackets)
 #endif
 
 	// Send
+	packetsSentStat.add();
+	bytesSentStat.add(int64_t(pos));
 	parent->send(OutboundNetworkPacket(dst.subspan(0, pos)));
 }
 
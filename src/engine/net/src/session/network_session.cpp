@@ -2,6 +2,7 @@
 #include "session/network_session_control_messages.h"
 #include "connection/network_service.h"
 #include "connection/network_packet.h"
+#include "halley/support/memory_tracker.h"
 using namespace Halley;
 
 NetworkSession::NetworkSession(NetworkService& service)
@@ -104,6 +105,8 @@ void NetworkSession::acceptConnection(std::shared_ptr<IConnection> incoming)
 
 void NetworkSession::update()
 {
+	MemoryTagScope memTag(MemoryTag::Network);
+
 	// Remove dead connections
 	service.update();
 	connections.erase(std::remove_if(connections.begin(), connections.end(), [] (const std::shared_ptr<IConnection>& c) { return c->getStatus() == ConnectionStatus::Closed; }), connections.end());
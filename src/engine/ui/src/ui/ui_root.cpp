@@ -5,6 +5,7 @@
 #include "halley/audio/audio_position.h"
 #include "halley/audio/audio_clip.h"
 #include "halley/maths/random.h"
+#include "halley/support/memory_tracker.h"
 
 using namespace Halley;
 
@@ -46,6 +47,7 @@ Rect4f UIRoot::getRect() const
 
 void UIRoot::update(Time t, UIInputType activeInputType, spInputDevice mouse, spInputDevice manual)
 {
+	MemoryTagScope memTag(MemoryTag::UI);
 	auto joystickType = manual->getJoystickType();
 	bool first = true;
 
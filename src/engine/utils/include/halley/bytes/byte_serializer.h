@@ -3,6 +3,7 @@
 #include <halley/utils/utils.h>
 #include <vector>
 #include <gsl/gsl>
+#include <gsl/string_span>
 #include "halley/data_structures/flat_map.h"
 #include "halley/maths/vector2.h"
 #include "halley/maths/rect.h"
@@ -18,19 +19,32 @@
 namespace Halley {
 	class String;
 
+	// Types whose serialized form is exactly their in-memory representation, so contiguous arrays of them are copied in one go.
+	// Specialise for other trivially copyable types only if their serialize() writes every member in order, with no padding.
+	template <typename T>
+	struct IsBulkSerializable : std::integral_constant<bool, (std::is_arithmetic<T>::value && !std::is_same<T, bool>::value) || std::is_enum<T>::value> {};
+
+	template <typename T>
+	struct IsBulkSerializable<Vector2D<T>> : std::integral_constant<bool, IsBulkSerializable<T>::value && sizeof(Vector2D<T>) == 2 * sizeof(T)> {};
+
+	template <typename T>
+	struct IsBulkSerializable<Vector4D<T>> : std::integral_constant<bool, IsBulkSerializable<T>::value && sizeof(Vector4D<T>) == 4 * sizeof(T)> {};
+
 	class Serializer {
 	public:
-		Serializer();
-		explicit Serializer(gsl::span<gsl::byte> dst);
+		Serializer(); // Only measures, see getSize()
+		explicit Serializer(gsl::span<gsl::byte> dst); // Writes into dst, throws if it doesn't fit
+		explicit Serializer(Bytes& dst); // Replaces the contents of dst, growing it as needed. Its capacity is reused, so keep it around between calls.
+		~Serializer();
+
+		Serializer(const Serializer& other) = delete;
+		Serializer& operator=(const Serializer& other) = delete;
 
 		template <typename T, typename std::enable_if<std::is_convertible<T, std::function<void(Serializer&)>>::value, int>::type = 0>
 		static Bytes toBytes(const T& f)
 		{
-			Serializer dry;
-			f(dry);
-			Bytes result(dry.getSize());
-			Serializer s(gsl::as_writeable_bytes(gsl::span<Halley::Byte>(result)));
-			f(s);
+			Bytes result;
+			toBytes(f, result);
 			return result;
 		}
 
@@ -40,6 +54,20 @@ namespace Halley {
 			return toBytes([&value](Serializer& s) { s << value; });
 		}
 
+		template <typename T, typename std::enable_if<std::is_convertible<T, std::function<void(Serializer&)>>::value, int>::type = 0>
+		static void toBytes(const T& f, Bytes& dst)
+		{
+			Serializer s(dst);
+			f(s);
+		}
+
+		template <typename T, typename std::enable_if<!std::is_convertible<T, std::function<void(Serializer&)>>::value, int>::type = 0>
+		static void toBytes(const T& value, Bytes& dst)
+		{
+			Serializer s(dst);
+			s << value;
+		}
+
 		size_t getSize() const { return size; }
 
 		Serializer& operator<<(bool val) { return serializePod(val); }
@@ -60,7 +88,7 @@ namespace Halley {
 		Serializer& operator<<(gsl::span<const gsl::byte> span);
 		Serializer& operator<<(const Bytes& bytes);
 
-		template <typename T>
+		template <typename T, std::enable_if_t<!IsBulkSerializable<T>::value, int> = 0>
 		Serializer& operator<<(const std::vector<T>& val)
 		{
 			unsigned int sz = static_cast<unsigned int>(val.size());
@@ -71,6 +99,15 @@ namespace Halley {
 			return *this;
 		}
 
+		template <typename T, std::enable_if_t<IsBulkSerializable<T>::value, int> = 0>
+		Serializer& operator<<(const std::vector<T>& val)
+		{
+			unsigned int sz = static_cast<unsigned int>(val.size());
+			*this << sz;
+			writeBytes(val.data(), sz * sizeof(T));
+			return *this;
+		}
+
 		template <typename T, typename U>
 		Serializer& operator<<(const FlatMap<T, U>& val)
 		{
@@ -169,23 +206,71 @@ namespace Halley {
 	private:
 		bool dryRun;
 		size_t size = 0;
-		gsl::span<gsl::byte> dst;
+		gsl::byte* dst = nullptr;
+		size_t capacity = 0;
+		Bytes* growable = nullptr;
 
 		template <typename T>
 		Serializer& serializePod(T val)
 		{
+			if (size + sizeof(T) > capacity) {
+				reserveBytes(sizeof(T));
+			}
 			if (!dryRun) {
-				memcpy(dst.data() + size, &val, sizeof(T));
+				memcpy(dst + size, &val, sizeof(T));
 			}
 			size += sizeof(T);
 			return *this;
 		}
+
+		void writeBytes(const void* src, size_t n);
+		void reserveBytes(size_t n);
 	};
 
+	// Points into the buffer being deserialized instead of copying out of it, so the buffer must outlive the view.
+	// In dev builds, if the Deserializer was given the buffer's owner, every access checks that the owner is still alive.
+	template <typename T>
+	class DeserializedView {
+	public:
+		DeserializedView() = default;
+
+		const T& get() const
+		{
+		#ifdef DEV_BUILD
+			if (hasOwner && owner.expired()) {
+				onSourceExpired();
+			}
+		#endif
+			return view;
+		}
+
+		const T& operator*() const { return get(); }
+		const T* operator->() const { return &get(); }
+
+		size_t size() const { return size_t(view.size()); }
+		bool empty() const { return view.empty(); }
+
+	private:
+		friend class Deserializer;
+
+		// Kept in every build so the layout doesn't depend on DEV_BUILD; only the check in get() does
+		T view;
+		std::weak_ptr<const void> owner;
+		bool hasOwner = false;
+
+		[[noreturn]] static void onSourceExpired();
+	};
+
+	using DeserializedStringView = DeserializedView<gsl::cstring_span<>>;
+	using DeserializedBytesView = DeserializedView<gsl::span<const gsl::byte>>;
+
 	class Deserializer {
 	public:
 		Deserializer(gsl::span<const gsl::byte> src);
 		explicit Deserializer(const Bytes& src);
+
+		// owner keeps src alive, it's only used to validate views in dev builds
+		Deserializer(gsl::span<const gsl::byte> src, std::shared_ptr<const void> owner);
 		
 		template <typename T>
 		static T fromBytes(const Bytes& src)
@@ -237,7 +322,13 @@ namespace Halley {
 		Deserializer& operator>>(gsl::span<gsl::byte>& span);
 		Deserializer& operator>>(Bytes& bytes);
 
-		template <typename T>
+		// Zero-copy reads, for data written as String/std::string and Bytes respectively
+		Deserializer& operator>>(DeserializedStringView& view);
+		Deserializer& operator>>(DeserializedBytesView& view);
+		DeserializedStringView readStringView();
+		DeserializedBytesView readBytesView();
+
+		template <typename T, std::enable_if_t<!IsBulkSerializable<T>::value, int> = 0>
 		Deserializer& operator>>(std::vector<T>& val)
 		{
 			unsigned int sz;
@@ -253,6 +344,19 @@ namespace Halley {
 			return *this;
 		}
 
+		template <typename T, std::enable_if_t<IsBulkSerializable<T>::value, int> = 0>
+		Deserializer& operator>>(std::vector<T>& val)
+		{
+			unsigned int sz;
+			*this >> sz;
+			ensureSufficientBytesRemaining(size_t(sz) * sizeof(T));
+
+			val.resize(sz);
+			memcpy(val.data(), src.data() + pos, size_t(sz) * sizeof(T));
+			pos += size_t(sz) * sizeof(T);
+			return *this;
+		}
+
 		template <typename T, typename U>
 		Deserializer& operator>>(FlatMap<T, U>& val)
 		{
@@ -279,7 +383,7 @@ namespace Halley {
 				T key;
 				U value;
 				*this >> key >> value;
-				val[key] = std::move(value);
+				val[std::move(key)] = std::move(value);
 			}
 			return *this;
 		}
@@ -295,7 +399,7 @@ namespace Halley {
 				T key;
 				U value;
 				*this >> key >> value;
-				val[key] = std::move(value);
+				val[std::move(key)] = std::move(value);
 			}
 			return *this;
 		}
@@ -394,6 +498,19 @@ namespace Halley {
 		size_t pos = 0;
 		gsl::span<const gsl::byte> src;
 		int version = 0;
+		std::shared_ptr<const void> owner;
+
+		template <typename T>
+		DeserializedView<T> makeView(T view) const
+		{
+			DeserializedView<T> result;
+			result.view = view;
+			result.owner = owner;
+			result.hasOwner = owner != nullptr;
+			return result;
+		}
+
+		gsl::span<const gsl::byte> readSizedSpan();
 
 		template <typename T>
 		Deserializer& deserializePod(T& val)
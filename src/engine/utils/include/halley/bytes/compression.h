@@ -2,17 +2,90 @@
 #include "../utils/utils.h"
 #include <gsl/gsl>
 #include <limits>
+#include <memory>
+
+struct z_stream_s;
 
 namespace Halley {
+	// zlib is the only codec in the tree, so speed is traded against ratio by picking the deflate level
+	enum class CompressionLevel {
+		Fast,
+		Default,
+		Best
+	};
+
+	struct CompressionStepResult {
+		size_t bytesRead = 0;
+		size_t bytesWritten = 0;
+		bool finished = false;
+	};
+
+	// Reusable deflate context. reset() is much cheaper than setting up a new stream, so keep one around
+	// (or use getThreadLocal) when compressing many small buffers.
+	class Compressor {
+	public:
+		explicit Compressor(CompressionLevel level = CompressionLevel::Default);
+		~Compressor();
+		Compressor(const Compressor& other) = delete;
+		Compressor& operator=(const Compressor& other) = delete;
+
+		void reset();
+		CompressionLevel getLevel() const { return level; }
+
+		// Consumes as much of src and fills as much of dst as it can. Set finish on the last call of the stream,
+		// and keep calling it with more output space until the result reports finished.
+		CompressionStepResult update(gsl::span<const gsl::byte> src, gsl::span<gsl::byte> dst, bool finish);
+
+		// One shot helpers, these reset the stream first. The span version throws if dst is too small;
+		// the Bytes version appends to dst, reusing its capacity.
+		size_t compress(gsl::span<const gsl::byte> src, gsl::span<gsl::byte> dst);
+		void compress(gsl::span<const gsl::byte> src, Bytes& dst);
+
+		static size_t getMaxCompressedSize(size_t srcSize);
+
+		static Compressor& getThreadLocal(CompressionLevel level = CompressionLevel::Default);
+
+	private:
+		std::unique_ptr<z_stream_s> stream;
+		CompressionLevel level;
+		bool dirty = false;
+	};
+
+	class Decompressor {
+	public:
+		Decompressor();
+		~Decompressor();
+		Decompressor(const Decompressor& other) = delete;
+		Decompressor& operator=(const Decompressor& other) = delete;
+
+		void reset();
+
+		// See Compressor::update. The result is finished once the end of the stream has been reached.
+		CompressionStepResult update(gsl::span<const gsl::byte> src, gsl::span<gsl::byte> dst);
+
+		// Inflates a whole stream into dst, which must be exactly large enough. Returns the number of bytes written.
+		size_t decompress(gsl::span<const gsl::byte> src, gsl::span<gsl::byte> dst);
+
+		// Inflates a whole stream of unknown size, appending it to dst
+		void decompress(gsl::span<const gsl::byte> src, Bytes& dst, size_t maxSize = std::numeric_limits<size_t>::max());
+
+		static Decompressor& getThreadLocal();
+
+	private:
+		std::unique_ptr<z_stream_s> stream;
+		bool dirty = false;
+	};
+
 	class Compression {
 	public:
-		static Bytes compress(const Bytes& bytes);
-		static Bytes compress(gsl::span<const gsl::byte> bytes);
+		static Bytes compress(const Bytes& bytes, CompressionLevel level = CompressionLevel::Default);
+		static Bytes compress(gsl::span<const gsl::byte> bytes, CompressionLevel level = CompressionLevel::Default);
 		static Bytes decompress(const Bytes& bytes, size_t maxSize = std::numeric_limits<size_t>::max());
 		static Bytes decompress(gsl::span<const gsl::byte> bytes, size_t maxSize = std::numeric_limits<size_t>::max());
 		static std::shared_ptr<const char> decompressToSharedPtr(gsl::span<const gsl::byte> bytes, size_t& outSize, size_t maxSize = std::numeric_limits<size_t>::max());
 
-		static Bytes compressRaw(gsl::span<const gsl::byte> bytes, bool insertLength);
+		static Bytes compressRaw(gsl::span<const gsl::byte> bytes, bool insertLength, CompressionLevel level = CompressionLevel::Default);
+		static void compressRaw(gsl::span<const gsl::byte> bytes, Bytes& out, bool insertLength, CompressionLevel level = CompressionLevel::Default); // Appends to out
 		static Bytes decompressRaw(gsl::span<const gsl::byte> bytes, size_t maxSize, size_t expectedSize = 0);
 	};
 }
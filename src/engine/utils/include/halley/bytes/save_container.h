@@ -0,0 +1,87 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <vector>
+#include <gsl/gsl>
+#include "halley/utils/utils.h"
+#include "halley/text/halleystring.h"
+
+namespace Halley {
+	class Serializer;
+	class Deserializer;
+
+	// Save file made of named sections, each compressed independently.
+	// The table of contents sits at the start of the file, so sections are only inflated when requested.
+	//
+	// A container can also be written as a delta against a base container (typically the last full save),
+	// storing only the sections (and, inside them, the blocks) that changed. Loading a delta requires the
+	// same base it was written against; always write deltas against a full save rather than another delta.
+	//
+	// Not thread-safe: reading a section inflates and caches it.
+	class SaveContainer {
+	public:
+		SaveContainer();
+
+		void setSection(const String& name, Bytes data);
+		void removeSection(const String& name);
+		bool hasSection(const String& name) const;
+		const Bytes& getSection(const String& name) const;
+		std::vector<String> getSectionNames() const;
+
+		// Identifies the contents of this container, used to match deltas to their base
+		uint64_t getId() const;
+
+		Bytes toBytes() const;
+		Bytes toDeltaBytes(const SaveContainer& base) const;
+
+		static SaveContainer fromBytes(Bytes data);
+		static SaveContainer fromBytes(Bytes data, const SaveContainer& base);
+
+		// Returns the id of the base container that this data was written against, or 0 if it's a full save
+		static uint64_t getBaseId(gsl::span<const gsl::byte> data);
+
+	private:
+		enum class Encoding : uint8_t {
+			Raw,
+			Compressed,
+			Delta,
+			Unchanged
+		};
+
+		struct TableEntry {
+			String name;
+			Encoding encoding = Encoding::Raw;
+			uint64_t offset = 0;
+			uint64_t size = 0;
+			uint64_t rawSize = 0;
+			uint64_t rawHash = 0;
+
+			void serialize(Serializer& s) const;
+			void deserialize(Deserializer& s);
+		};
+
+		struct Section {
+			uint64_t rawSize = 0;
+			uint64_t rawHash = 0;
+
+			// Either the decoded data, or a compressed range of the file it was loaded from
+			mutable std::shared_ptr<const Bytes> data;
+			mutable std::shared_ptr<const Bytes> file;
+			size_t offset = 0;
+			size_t size = 0;
+
+			const Bytes& getData() const;
+		};
+
+		constexpr static size_t deltaBlockSize = 4096;
+
+		std::map<String, Section> sections;
+
+		Bytes write(const SaveContainer* base) const;
+		static SaveContainer read(Bytes data, const SaveContainer* base);
+
+		static Bytes makeDelta(const Bytes& base, const Bytes& data);
+		static Bytes applyDelta(const Bytes& base, gsl::span<const gsl::byte> delta, size_t rawSize);
+	};
+}
@@ -43,6 +43,7 @@ namespace Halley
 	public:
 		static Executors& get();
 		static void set(Executors& e);
+		static bool hasInstance() { return instance != nullptr; }
 
 		static ExecutionQueue& getCPU() { return instance->cpu; }
 		static ExecutionQueue& getCPUAux() { return instance->cpuAux; }
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <gsl/gsl_assert>
+#include "halley/utils/utils.h"
+
+namespace Halley {
+	// Bounded, lock-free, single-producer single-consumer queue.
+	// Exactly one thread may push and exactly one (possibly different) thread may pop.
+	template <typename T>
+	class SPSCQueue {
+	public:
+		explicit SPSCQueue(size_t capacity)
+			: data(nextPowerOf2(capacity))
+			, mask(data.size() - 1)
+			, readPos(0)
+			, writePos(0)
+		{
+			static_assert(std::is_trivially_copyable<T>::value, "SPSCQueue elements must be trivially copyable");
+			Expects(capacity > 0);
+		}
+
+		SPSCQueue(const SPSCQueue& other) = delete;
+		SPSCQueue& operator=(const SPSCQueue& other) = delete;
+
+		size_t getCapacity() const { return data.size(); }
+
+		bool tryPush(const T& value)
+		{
+			const size_t write = writePos.load(std::memory_order_relaxed);
+			if (write - readPos.load(std::memory_order_acquire) >= data.size()) {
+				return false;
+			}
+			data[write & mask] = value;
+			writePos.store(write + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool tryPop(T& value)
+		{
+			const size_t read = readPos.load(std::memory_order_relaxed);
+			if (read == writePos.load(std::memory_order_acquire)) {
+				return false;
+			}
+			value = data[read & mask];
+			readPos.store(read + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool empty() const
+		{
+			return readPos.load(std::memory_order_acquire) == writePos.load(std::memory_order_acquire);
+		}
+
+	private:
+		std::vector<T> data;
+		const size_t mask;
+
+		// Kept on separate cache lines so producer and consumer don't false-share
+		alignas(64) std::atomic<size_t> readPos;
+		alignas(64) std::atomic<size_t> writePos;
+	};
+}
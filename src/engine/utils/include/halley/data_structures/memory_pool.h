@@ -1,8 +1,17 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
 #include "flat_map.h"
 
 namespace Halley {
+	// Fixed size block allocator, safe to use from any thread.
+	// Each thread keeps a small cache of free blocks per pool, so most allocations and frees don't touch the shared pool at all;
+	// when the cache runs empty or full, blocks are moved in batches under a lock that's specific to this pool.
+	// Blocks can be freed on a different thread from the one that allocated them.
+	// Pools are expected to live until the end of the program, as thread caches may still reference them.
 	class SizePool
 	{
 	public:
@@ -14,20 +23,52 @@ namespace Halley {
 		void free(void* p);
 
 	private:
+		constexpr static size_t threadCacheSize = 32;
+
+		struct ThreadCache {
+			SizePool* pool = nullptr;
+			size_t count = 0;
+			std::array<void*, threadCacheSize> blocks;
+		};
+
+		struct ThreadCaches {
+			std::vector<ThreadCache> caches;
+			~ThreadCaches();
+		};
+
 		void* pimpl;
 		size_t size;
+		size_t index;
+		std::mutex mutex;
+
+		ThreadCache* getThreadCache();
+		void refill(ThreadCache& cache, size_t n);
+		void release(ThreadCache& cache, size_t n);
 	};
 
 	// yo dawg
+	// Lookups for small sizes are a single atomic load from an append-only table; pools are created on first use.
 	class PoolPool
 	{
 	public:
 		static SizePool* getPool(size_t size);
 
+		template <typename T>
+		static SizePool* getPool()
+		{
+			static SizePool* pool = getPool(sizeof(T));
+			return pool;
+		}
+
 	private:
+		constexpr static size_t maxDirectSize = 2048;
+
+		PoolPool();
 		static PoolPool& get();
 
-		FlatMap<size_t, SizePool*> pools;
+		std::array<std::atomic<SizePool*>, maxDirectSize + 1> directPools;
+		FlatMap<size_t, SizePool*> pools; // Sizes above maxDirectSize, guarded by mutex
+		std::mutex mutex;
 	};
 
 	template <typename T>
@@ -36,27 +77,13 @@ namespace Halley {
 	public:
 		static void* alloc()
 		{
-			return get().pool->alloc();
+			return PoolPool::getPool<T>()->alloc();
 		}
 
 		static void free(void* p)
 		{
-			get().pool->free(p);
+			PoolPool::getPool<T>()->free(p);
 		}
-
-	private:
-		PoolAllocator()
-		{
-			pool = new SizePool(sizeof(T));
-		}
-
-		static PoolAllocator& get()
-		{
-			static PoolAllocator instance;
-			return instance;
-		}
-
-		SizePool* pool;
 	};
-	
+
 }
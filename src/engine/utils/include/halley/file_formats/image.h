@@ -43,6 +43,11 @@ namespace Halley {
 			RGBAPremultiplied
 		};
 
+		enum class PNGEncoding {
+			Small,
+			Fast
+		};
+
 		Image(Format format = Format::RGBA, Vector2i size = {});
 		Image(gsl::span<const gsl::byte> bytes, Format format = Format::Undefined);
 		explicit Image(const ResourceDataStatic& data);
@@ -52,7 +57,7 @@ namespace Halley {
 		void setSize(Vector2i size);
 
 		void load(gsl::span<const gsl::byte> bytes, Format format = Format::Undefined);
-		Bytes savePNGToBytes(bool allowDepthReduce = true) const;
+		Bytes savePNGToBytes(bool allowDepthReduce = true, PNGEncoding encoding = PNGEncoding::Small) const;
 		static Vector2i getImageSize(gsl::span<const gsl::byte> bytes);
 		static Format getImageFormat(gsl::span<const gsl::byte> bytes);
 		static bool isPNG(gsl::span<const gsl::byte> bytes);
@@ -118,4 +123,14 @@ namespace Halley {
 			}};
 		}
 	};
+
+	template <>
+	struct EnumNames<Image::PNGEncoding> {
+		constexpr std::array<const char*, 2> operator()() const {
+			return{{
+				"small",
+				"fast"
+			}};
+		}
+	};
 }
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include "vector2.h"
+
+namespace Halley {
+	// Signed 48.16 fixed point number. All operations are integer only, so results are bit-identical on every
+	// platform and compiler, which floats can't promise. Intended for simulations running in lockstep.
+	// Products and quotients use a 128-bit intermediate, so they're correct as long as the result itself fits in 48.16.
+	class Fixed {
+	public:
+		constexpr static int fractionBits = 16;
+		constexpr static int64_t one = int64_t(1) << fractionBits;
+
+		constexpr Fixed() : raw(0) {}
+		constexpr explicit Fixed(int value) : raw(int64_t(value) * one) {}
+		constexpr explicit Fixed(int64_t value) : raw(value * one) {}
+
+		constexpr static Fixed fromRaw(int64_t raw) { Fixed result; result.raw = raw; return result; }
+		constexpr static Fixed fromRatio(int64_t numerator, int64_t denominator) { return fromRaw(numerator * one / denominator); }
+
+		// Conversion from float is exact for the same input on any platform, but only use it for setup data, never for simulation results
+		static Fixed fromFloat(float value) { return fromRaw(int64_t(double(value) * double(one))); }
+		static Fixed fromDouble(double value) { return fromRaw(int64_t(value * double(one))); }
+
+		constexpr int64_t getRaw() const { return raw; }
+		constexpr float toFloat() const { return float(double(raw) / double(one)); }
+		constexpr double toDouble() const { return double(raw) / double(one); }
+		constexpr int64_t floorToInt() const { return raw >> fractionBits; }
+		constexpr int64_t ceilToInt() const { return (raw + one - 1) >> fractionBits; }
+		constexpr int64_t roundToInt() const { return (raw + one / 2) >> fractionBits; }
+
+		constexpr Fixed floor() const { return fromRaw(raw & ~(one - 1)); }
+		constexpr Fixed ceil() const { return fromRaw((raw + one - 1) & ~(one - 1)); }
+		constexpr Fixed abs() const { return fromRaw(raw < 0 ? -raw : raw); }
+
+		constexpr Fixed operator+(Fixed other) const { return fromRaw(raw + other.raw); }
+		constexpr Fixed operator-(Fixed other) const { return fromRaw(raw - other.raw); }
+		Fixed operator*(Fixed other) const { return fromRaw(mulRaw(raw, other.raw)); }
+		Fixed operator/(Fixed other) const { return fromRaw(divRaw(raw, other.raw)); }
+		constexpr Fixed operator-() const { return fromRaw(-raw); }
+
+		constexpr Fixed operator*(int other) const { return fromRaw(raw * other); }
+		constexpr Fixed operator/(int other) const { return fromRaw(raw / other); }
+
+		Fixed& operator+=(Fixed other) { raw += other.raw; return *this; }
+		Fixed& operator-=(Fixed other) { raw -= other.raw; return *this; }
+		Fixed& operator*=(Fixed other) { *this = *this * other; return *this; }
+		Fixed& operator/=(Fixed other) { *this = *this / other; return *this; }
+
+		constexpr bool operator==(Fixed other) const { return raw == other.raw; }
+		constexpr bool operator!=(Fixed other) const { return raw != other.raw; }
+		constexpr bool operator<(Fixed other) const { return raw < other.raw; }
+		constexpr bool operator>(Fixed other) const { return raw > other.raw; }
+		constexpr bool operator<=(Fixed other) const { return raw <= other.raw; }
+		constexpr bool operator>=(Fixed other) const { return raw >= other.raw; }
+
+		// Integer square root, exact to the last fractional bit (rounded down). Returns zero for negative values.
+		static Fixed sqrt(Fixed value)
+		{
+			if (value.raw <= 0) {
+				return Fixed();
+			}
+
+			// sqrt(raw / one) * one == sqrt(raw * one). raw * one needs up to 79 bits, so instead of shifting the input,
+			// take its digits two bits at a time from the top and feed zeros for the fractional part.
+			// The remainder stays below 2 * root + 1 < 2^42, so everything fits in 64 bits.
+			const uint64_t x = uint64_t(value.raw);
+			uint64_t remainder = 0;
+			uint64_t root = 0;
+			for (int i = (64 + fractionBits) / 2 - 1; i >= 0; --i) {
+				const int shift = 2 * i - fractionBits;
+				const uint64_t digits = shift >= 0 ? (x >> shift) & 3 : 0;
+				remainder = (remainder << 2) | digits;
+				root <<= 1;
+				const uint64_t candidate = (root << 1) | 1;
+				if (remainder >= candidate) {
+					remainder -= candidate;
+					root |= 1;
+				}
+			}
+			return fromRaw(int64_t(root));
+		}
+
+		constexpr static Fixed min(Fixed a, Fixed b) { return a < b ? a : b; }
+		constexpr static Fixed max(Fixed a, Fixed b) { return a > b ? a : b; }
+		constexpr static Fixed clamp(Fixed value, Fixed low, Fixed high) { return max(low, min(value, high)); }
+
+		constexpr static Fixed maxValue() { return fromRaw(std::numeric_limits<int64_t>::max()); }
+		constexpr static Fixed minValue() { return fromRaw(std::numeric_limits<int64_t>::min()); }
+
+	private:
+		int64_t raw;
+
+		// (a * b) >> fractionBits, rounding towards negative infinity
+		static int64_t mulRaw(int64_t a, int64_t b)
+		{
+		#ifdef __SIZEOF_INT128__
+			return int64_t((__int128(a) * __int128(b)) >> fractionBits);
+		#else
+			// Multiply magnitudes into hi:lo, restore the sign in two's complement, then shift the 128-bit value
+			const bool negative = (a < 0) != (b < 0);
+			const uint64_t ua = a < 0 ? 0 - uint64_t(a) : uint64_t(a);
+			const uint64_t ub = b < 0 ? 0 - uint64_t(b) : uint64_t(b);
+			const uint64_t aLo = ua & 0xFFFFFFFFull;
+			const uint64_t aHi = ua >> 32;
+			const uint64_t bLo = ub & 0xFFFFFFFFull;
+			const uint64_t bHi = ub >> 32;
+			const uint64_t ll = aLo * bLo;
+			const uint64_t lh = aLo * bHi;
+			const uint64_t hl = aHi * bLo;
+			const uint64_t mid = (ll >> 32) + (lh & 0xFFFFFFFFull) + (hl & 0xFFFFFFFFull);
+			uint64_t lo = (ll & 0xFFFFFFFFull) | (mid << 32);
+			uint64_t hi = aHi * bHi + (lh >> 32) + (hl >> 32) + (mid >> 32);
+			if (negative) {
+				lo = ~lo + 1;
+				hi = ~hi + (lo == 0 ? 1 : 0);
+			}
+			return int64_t((lo >> fractionBits) | (hi << (64 - fractionBits)));
+		#endif
+		}
+
+		// (a << fractionBits) / b, rounding towards zero like integer division
+		static int64_t divRaw(int64_t a, int64_t b)
+		{
+		#ifdef __SIZEOF_INT128__
+			return int64_t((__int128(a) * one) / __int128(b));
+		#else
+			// Long division of the 80-bit magnitude |a| << fractionBits by |b|
+			const bool negative = (a < 0) != (b < 0);
+			const uint64_t ua = a < 0 ? 0 - uint64_t(a) : uint64_t(a);
+			const uint64_t ub = b < 0 ? 0 - uint64_t(b) : uint64_t(b);
+			uint64_t quotient = ua / ub;
+			uint64_t remainder = ua % ub;
+			for (int i = 0; i < fractionBits; ++i) {
+				// remainder < ub <= 2^63, so remainder * 2 can't wrap
+				remainder <<= 1;
+				quotient <<= 1;
+				if (remainder >= ub) {
+					remainder -= ub;
+					quotient |= 1;
+				}
+			}
+			return negative ? int64_t(0 - quotient) : int64_t(quotient);
+		#endif
+		}
+	};
+
+	constexpr inline Fixed operator*(int a, Fixed b) { return b * a; }
+
+	// Vector of fixed point values. Algebra, dot/cross and squaredLength work as in Vector2f;
+	// for lengths and normalisation use lengthFixed and unitFixed, as the float versions go through std::sqrt.
+	typedef Vector2D<Fixed, Angle<float>> Vector2fx;
+
+	inline Fixed lengthFixed(Vector2fx v)
+	{
+		return Fixed::sqrt(v.squaredLength());
+	}
+
+	inline Vector2fx unitFixed(Vector2fx v)
+	{
+		const Fixed len = lengthFixed(v);
+		return len == Fixed() ? Vector2fx() : Vector2fx(v.x / len, v.y / len);
+	}
+}
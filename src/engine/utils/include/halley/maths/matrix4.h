@@ -22,6 +22,7 @@
 #pragma once
 
 #include <array>
+#include <gsl/span>
 #include "angle.h"
 #include "vector2.h"
 
@@ -38,6 +39,14 @@ namespace Halley {
 		Matrix4f operator*(const Matrix4f& param) const;
 		Vector2f operator*(const Vector2f& param) const;
 
+		// Same as operator*(Vector2f) on each point, four at a time; src and dst may be the same span
+		void transformPoints(gsl::span<Vector2f> points) const;
+		void transformPoints(gsl::span<const Vector2f> src, gsl::span<Vector2f> dst) const;
+
+		// Returns the inverse, or identity if the matrix is singular
+		Matrix4f inverted() const;
+		bool isAffine2D() const;
+
 		static Matrix4f makeIdentity();
 		static Matrix4f makeRotationZ(Angle1f angle);
 		static Matrix4f makeScaling2D(float scaleX, float scaleY);
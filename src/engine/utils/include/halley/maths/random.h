@@ -24,15 +24,19 @@
 #include <halley/utils/utils.h>
 #include <halley/support/exception.h>
 #include <gsl/span>
+#include <array>
 #include <cstdint>
 
 namespace Halley {
-	class MT199937AR;
-
+	// xoshiro256** generator: 32 bytes of state, no allocation
 	class Random {
 	public:
+		// Shared instance; not thread-safe, only use it from the main thread and prefer getThreadLocal() anywhere else
 		static Random& getGlobal();
 
+		// One instance per thread, seeded on first use
+		static Random& getThreadLocal();
+
 		Random();
 		Random(uint32_t seed);
 		Random(gsl::span<const gsl::byte> data);
@@ -71,12 +75,27 @@ namespace Halley {
 		void setSeed(uint32_t seed);
 		void setSeed(gsl::span<const gsl::byte> data);
 
+		// Bulk generation, considerably faster than calling the single value versions in a loop
+		void getFloats(gsl::span<float> dst, float min, float max); // [min, max)
+		void getInts(gsl::span<int32_t> dst, int32_t min, int32_t max); // [min, max]
+
+		// Advance the generator by 2^128 (jump) or 2^192 (longJump) steps.
+		// Copies of a seeded generator, each jumped a different number of times, give non-overlapping parallel streams.
+		void jump();
+		void longJump();
+
+		// Returns a new generator whose sequence starts 2^128 steps ahead of this one, and jumps this one past it
+		Random split();
+
 		uint32_t getRawInt();
+		uint64_t getRawInt64();
 		float getRawFloat();
 		double getRawDouble();
 
 	private:
-		std::unique_ptr<MT199937AR> generator;
+		std::array<uint64_t, 4> state;
+
+		void doJump(const std::array<uint64_t, 4>& polynomial);
 	};
 
 }
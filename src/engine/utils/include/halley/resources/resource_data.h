@@ -65,6 +65,7 @@ namespace Halley {
 
 		const void* getData() const;
 		gsl::span<const gsl::byte> getSpan() const;
+		std::shared_ptr<const char> getSharedData() const; // Keeps the data alive, e.g. for Deserializer views into it
 		size_t getSize() const;
 		String getString() const;
 		void inflate();
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "halley/text/halleystring.h"
+
+namespace Halley
+{
+	enum class MemoryTag : uint8_t
+	{
+		Untagged,
+		World,
+		Resources,
+		Graphics,
+		Audio,
+		UI,
+		Network,
+
+		NUMBER_OF_TAGS
+	};
+
+	struct MemoryTagStats
+	{
+		int64_t liveBytes = 0;
+		int64_t liveAllocations = 0;
+		int64_t totalBytes = 0;
+		int64_t totalAllocations = 0;
+	};
+
+	struct MemoryCallSite
+	{
+		const void* address = nullptr; // Return address into the caller of operator new, resolve with addr2line or the debugger
+		int64_t allocations = 0;
+		int64_t bytes = 0;
+	};
+
+	// Heap instrumentation, compiled in by building with HALLEY_TRACK_ALLOCATIONS (see the CMake option of the same name).
+	// When enabled, global operator new/delete are replaced, and every allocation is attributed to the innermost
+	// MemoryTagScope on the allocating thread. Call sites are sampled, so their counts are estimates.
+	class MemoryTracker
+	{
+	public:
+		constexpr static bool isEnabled()
+		{
+		#ifdef HALLEY_TRACK_ALLOCATIONS
+			return true;
+		#else
+			return false;
+		#endif
+		}
+
+		static MemoryTag getCurrentTag();
+		static const char* getTagName(MemoryTag tag);
+
+		static MemoryTagStats getStats(MemoryTag tag);
+		static std::vector<MemoryCallSite> getTopCallSites(MemoryTag tag, size_t n = 10);
+
+		// Publishes live bytes and allocations per frame of each tag to Stats, call once per frame
+		static void publishStats();
+		static String getReport(size_t callSitesPerTag = 5);
+
+	private:
+		friend class MemoryTagScope;
+		static MemoryTag setCurrentTag(MemoryTag tag);
+	};
+
+	class MemoryTagScope
+	{
+	public:
+	#ifdef HALLEY_TRACK_ALLOCATIONS
+		explicit MemoryTagScope(MemoryTag tag) : prev(MemoryTracker::setCurrentTag(tag)) {}
+		~MemoryTagScope() { MemoryTracker::setCurrentTag(prev); }
+	#else
+		explicit MemoryTagScope(MemoryTag) {}
+	#endif
+
+		MemoryTagScope(const MemoryTagScope& other) = delete;
+		MemoryTagScope& operator=(const MemoryTagScope& other) = delete;
+
+	private:
+	#ifdef HALLEY_TRACK_ALLOCATIONS
+		MemoryTag prev;
+	#endif
+	};
+}
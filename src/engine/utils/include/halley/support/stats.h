@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "halley/text/halleystring.h"
+#include "halley/data_structures/circular_buffer.h"
+
+namespace Halley
+{
+	enum class StatKind
+	{
+		Counter,	// Accumulated during the frame, then reset (e.g. resource loads, packets sent)
+		Value		// Last value set during the frame (e.g. frame time, draw calls)
+	};
+
+	class Stats;
+
+	// Cheap handle for publishing to a stat from any thread. Default constructed handles are no-ops.
+	class StatHandle
+	{
+	public:
+		StatHandle() = default;
+
+		void add(int64_t value = 1) const
+		{
+			if (current) {
+				current->fetch_add(value, std::memory_order_relaxed);
+			}
+		}
+
+		void set(int64_t value) const
+		{
+			if (current) {
+				current->store(value, std::memory_order_relaxed);
+			}
+		}
+
+		bool isValid() const { return current != nullptr; }
+
+	private:
+		friend class Stats;
+		explicit StatHandle(std::atomic<int64_t>& current) : current(&current) {}
+
+		std::atomic<int64_t>* current = nullptr;
+	};
+
+	struct StatSummary
+	{
+		String name;
+		StatKind kind;
+		int64_t latest = 0;
+		int64_t average = 0;
+		int64_t max = 0;
+		int64_t p50 = 0;
+		int64_t p95 = 0;
+		int64_t p99 = 0;
+	};
+
+	// Registry of named per-frame statistics. Subsystems publish through StatHandles, and once per frame
+	// the registry samples each stat into its history, so spikes can be inspected through percentiles.
+	class Stats
+	{
+	public:
+		explicit Stats(size_t historyLength = 600);
+
+		static void setInstance(Stats* stats);
+		static Stats* getInstance();
+
+		// Registers the stat on first use. Returns a no-op handle if there's no instance.
+		static StatHandle get(const String& name, StatKind kind = StatKind::Counter);
+
+		StatHandle getHandle(const String& name, StatKind kind);
+		void sampleFrame();
+		void clearHistory();
+
+		size_t getNumFrames() const;
+		std::vector<String> getNames() const;
+		bool hasStat(const String& name) const;
+
+		int64_t getLatest(const String& name) const;
+		int64_t getPercentile(const String& name, float percentile) const; // percentile in [0, 100]
+		StatSummary getSummary(const String& name) const;
+		std::vector<StatSummary> getSummaries() const;
+
+		String toCSV() const; // One row per sampled frame, oldest first, one column per stat
+		String toJSON() const; // Summary of each stat
+
+	private:
+		struct Entry
+		{
+			Entry(String name, StatKind kind, size_t historyLength);
+
+			String name;
+			StatKind kind;
+			std::atomic<int64_t> current;
+			CircularBuffer<int64_t> history;
+		};
+
+		static Stats* instance;
+
+		mutable std::mutex mutex;
+		size_t historyLength;
+		size_t numFrames = 0;
+		std::vector<std::unique_ptr<Entry>> entries;
+
+		const Entry* tryGetEntry(const String& name) const;
+		StatSummary makeSummary(const Entry& entry) const;
+		static int64_t getNearestRank(const std::vector<int64_t>& sortedValues, float percentile);
+	};
+}
@@ -2,6 +2,7 @@
 
 #include "halleystring.h"
 #include <map>
+#include <memory>
 #include "halley/data_structures/maybe.h"
 
 namespace Halley {
@@ -10,6 +11,24 @@ namespace Halley {
 	class ConfigObserver;
 	class I18N;
 
+	// A localisation key with its hash precomputed. Keep these around (e.g. as statics) for strings looked up every frame.
+	class I18NKey
+	{
+	public:
+		explicit I18NKey(const char* key);
+		explicit I18NKey(String key);
+
+		const String& getString() const;
+		uint64_t getHash() const;
+
+		// FNV-1a, so the hash of a concatenation can be computed without building it: hashString(b, hashString(a)) == hashString(a + b)
+		static uint64_t hashString(const String& str, uint64_t seed = 14695981039346656037ull);
+
+	private:
+		String key;
+		uint64_t hash;
+	};
+
 	class LocalisedString
 	{
 		friend class I18N;
@@ -38,11 +57,13 @@ namespace Halley {
 
 	private:
 		explicit LocalisedString(String string);
-		explicit LocalisedString(const I18N& i18n, String key, String string);
+		explicit LocalisedString(const I18N& i18n, uint64_t keyHash, std::shared_ptr<const String> key, std::shared_ptr<const String> string);
 
+		// Keyed strings share their key and text with the I18N tables, so copies don't allocate
 		const I18N* i18n = nullptr;
-		String key;
-		String string;
+		uint64_t keyHash = 0;
+		std::shared_ptr<const String> key;
+		std::shared_ptr<const String> string;
 		int i18nVersion = 0;
 	};
 
@@ -78,6 +99,8 @@ namespace Halley {
 	class I18N {
 	public:
 		I18N();
+		I18N(const I18N& other) = delete; // Holds pointers into its own tables
+		I18N& operator=(const I18N& other) = delete;
 
 		void update();
 		void loadLocalisationFile(const ConfigFile& config);
@@ -87,14 +110,17 @@ namespace Halley {
 		std::vector<I18NLanguage> getLanguagesAvailable() const;
 
 		LocalisedString get(const String& key) const;
+		LocalisedString get(const I18NKey& key) const;
 		LocalisedString getPreProcessedUserString(const String& string) const;
 
 		template <typename T>
 		std::vector<LocalisedString> getVector(const String& keyPrefix, const T& keys) const
 		{
 			std::vector<LocalisedString> result;
+			result.reserve(keys.size());
+			const auto prefixHash = I18NKey::hashString(keyPrefix);
 			for (auto& k: keys) {
-				result.push_back(get(keyPrefix + k));
+				result.push_back(getWithPrefix(prefixHash, keyPrefix, k));
 			}
 			return result;
 		}
@@ -105,13 +131,39 @@ namespace Halley {
 		char getDecimalSeparator() const;
 
 	private:
+		friend class LocalisedString;
+
+		// Flat table sorted by key hash, with the hashes kept apart from the payload so the search stays in cache
+		class Table {
+		public:
+			struct Entry {
+				std::shared_ptr<const String> key;
+				std::shared_ptr<const String> value;
+			};
+
+			void add(const String& key, const String& value);
+			void compile();
+			const Entry* find(uint64_t hash) const;
+			size_t size() const;
+
+		private:
+			std::vector<uint64_t> hashes;
+			std::vector<Entry> entries;
+		};
+
 		I18NLanguage currentLanguage;
 		Maybe<I18NLanguage> fallbackLanguage;
-		std::map<I18NLanguage, std::map<String, String>> strings;
+		std::map<I18NLanguage, Table> strings;
 		std::map<String, ConfigObserver> observers;
+		const Table* currentTable = nullptr;
+		const Table* fallbackTable = nullptr;
 		int version = 0;
 
 		void loadLocalisation(const ConfigNode& node);
+		void updateTables();
+
+		LocalisedString get(uint64_t hash, const String* key) const;
+		LocalisedString getWithPrefix(uint64_t prefixHash, const String& prefix, const String& key) const;
 	};
 }
 
@@ -1,6 +1,11 @@
 #pragma once
 
 #include "utils.h"
+#include <array>
+#include <memory>
+#include <gsl/gsl>
+
+struct AES_ctx;
 
 namespace Halley {
 	class String;
@@ -9,5 +14,21 @@ namespace Halley {
 	public:
 		static Bytes encrypt(const Bytes& iv, const String& key, const Bytes& data);
 		static Bytes decrypt(const Bytes& iv, const String& key, const Bytes& data);
+
+		// AES-128 in counter mode. The keystream depends only on the position in the stream,
+		// so any range can be encrypted or decrypted on its own. Uses AES-NI when the CPU supports it.
+		class CTRCipher {
+		public:
+			CTRCipher(const Bytes& iv, const String& key);
+			~CTRCipher();
+
+			// Encrypts or decrypts (it's the same operation) data in place, where data starts at offset bytes into the stream
+			void apply(size_t offset, gsl::span<gsl::byte> data) const;
+
+		private:
+			std::unique_ptr<AES_ctx> ctx;
+			std::array<uint8_t, 16> iv;
+			bool useAESNI = false;
+		};
 	};
-}
\ No newline at end of file
+}
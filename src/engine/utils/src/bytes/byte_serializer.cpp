@@ -2,18 +2,40 @@
 #include <string>
 #include "halley/bytes/byte_serializer.h"
 #include "halley/text/halleystring.h"
+#include "halley/text/string_converter.h"
+#include "halley/support/exception.h"
+#include <limits>
 
 using namespace Halley;
 
 Serializer::Serializer()
 	: dryRun(true)
+	, capacity(std::numeric_limits<size_t>::max())
 {}
 
 Serializer::Serializer(gsl::span<gsl::byte> dst)
 	: dryRun(false)
-	, dst(dst)
+	, dst(dst.data())
+	, capacity(size_t(dst.size_bytes()))
 {}
 
+Serializer::Serializer(Bytes& dst)
+	: dryRun(false)
+	, growable(&dst)
+{
+	// Keep whatever is already allocated, it gets overwritten and trimmed to size at the end
+	dst.resize(dst.capacity());
+	this->dst = reinterpret_cast<gsl::byte*>(dst.data());
+	capacity = dst.size();
+}
+
+Serializer::~Serializer()
+{
+	if (growable) {
+		growable->resize(size);
+	}
+}
+
 Serializer& Serializer::operator<<(const std::string& str)
 {
 	const unsigned int sz = static_cast<unsigned int>(str.size());
@@ -34,10 +56,7 @@ Serializer& Serializer::operator<<(const Path& path)
 
 Serializer& Serializer::operator<<(gsl::span<const gsl::byte> span)
 {
-	if (!dryRun) {
-		memcpy(dst.data() + size, span.data(), span.size_bytes());
-	}
-	size += span.size_bytes();
+	writeBytes(span.data(), size_t(span.size_bytes()));
 	return *this;
 }
 
@@ -45,12 +64,31 @@ Serializer& Serializer::operator<<(const Bytes& bytes)
 {
 	const unsigned int byteSize = static_cast<unsigned int>(bytes.size());
 	*this << byteSize;
+	writeBytes(bytes.data(), bytes.size());
+	return *this;
+}
 
-	if (!dryRun) {
-		memcpy(dst.data() + size, bytes.data(), bytes.size());
+void Serializer::writeBytes(const void* src, size_t n)
+{
+	if (size + n > capacity) {
+		reserveBytes(n);
 	}
-	size += bytes.size();
-	return *this;
+	if (!dryRun && n > 0) {
+		memcpy(dst + size, src, n);
+	}
+	size += n;
+}
+
+void Serializer::reserveBytes(size_t n)
+{
+	if (!growable) {
+		throw Exception("Serializer ran out of space, needs " + toString(size + n) + " bytes but only has " + toString(capacity), HalleyExceptions::File);
+	}
+
+	constexpr size_t minCapacity = 256;
+	growable->resize(std::max(std::max(size + n, capacity * 2), minCapacity));
+	dst = reinterpret_cast<gsl::byte*>(growable->data());
+	capacity = growable->size();
 }
 
 Deserializer::Deserializer(gsl::span<const gsl::byte> src)
@@ -65,15 +103,17 @@ Deserializer::Deserializer(const Bytes& src)
 {
 }
 
-Deserializer& Deserializer::operator>>(std::string& str)
+Deserializer::Deserializer(gsl::span<const gsl::byte> src, std::shared_ptr<const void> owner)
+	: pos(0)
+	, src(src)
+	, owner(std::move(owner))
 {
-	unsigned int sz;
-	*this >> sz;
-
-	ensureSufficientBytesRemaining(sz);
+}
 
-	str = std::string(reinterpret_cast<const char*>(src.data() + pos), sz);
-	pos += sz;
+Deserializer& Deserializer::operator>>(std::string& str)
+{
+	const auto data = readSizedSpan();
+	str.assign(reinterpret_cast<const char*>(data.data()), size_t(data.size()));
 	return *this;
 }
 
@@ -119,6 +159,40 @@ Deserializer& Deserializer::operator>>(Bytes& bytes)
 	return *this;
 }
 
+Deserializer& Deserializer::operator>>(DeserializedStringView& view)
+{
+	view = readStringView();
+	return *this;
+}
+
+Deserializer& Deserializer::operator>>(DeserializedBytesView& view)
+{
+	view = readBytesView();
+	return *this;
+}
+
+DeserializedStringView Deserializer::readStringView()
+{
+	const auto data = readSizedSpan();
+	return makeView(gsl::cstring_span<>(reinterpret_cast<const char*>(data.data()), data.size()));
+}
+
+DeserializedBytesView Deserializer::readBytesView()
+{
+	return makeView(readSizedSpan());
+}
+
+gsl::span<const gsl::byte> Deserializer::readSizedSpan()
+{
+	unsigned int sz;
+	*this >> sz;
+	ensureSufficientBytesRemaining(sz);
+
+	const auto result = src.subspan(pos, sz);
+	pos += sz;
+	return result;
+}
+
 void Deserializer::setVersion(int v)
 {
 	version = v;
@@ -144,3 +218,12 @@ size_t Deserializer::getBytesRemaining() const
 		return size_t(src.size_bytes()) - pos;
 	}
 }
+
+template <typename T>
+void DeserializedView<T>::onSourceExpired()
+{
+	throw Exception("Deserialized view accessed after its source buffer was released", HalleyExceptions::File);
+}
+
+template class Halley::DeserializedView<gsl::cstring_span<>>;
+template class Halley::DeserializedView<gsl::span<const gsl::byte>>;
@@ -1,3 +1,4 @@
+#include <array>
 #include <cstdlib>
 #include <memory>
 #include "halley/bytes/compression.h"
@@ -18,14 +19,265 @@ static void zlibFree(voidpf opaque, voidpf address)
 	free(address);
 }
 
-Bytes Compression::compress(const Bytes& bytes)
+static std::unique_ptr<z_stream> makeStream()
 {
-	return compress(gsl::as_bytes(gsl::span<const Byte>(bytes)));
+	auto stream = std::make_unique<z_stream>();
+	stream->zalloc = &zlibAlloc;
+	stream->zfree = &zlibFree;
+	stream->opaque = nullptr;
+	stream->avail_in = 0;
+	stream->next_in = nullptr;
+	return stream;
 }
 
-Bytes Compression::compress(gsl::span<const gsl::byte> bytes)
+static int getZlibLevel(CompressionLevel level)
 {
-	return compressRaw(bytes, true);
+	switch (level) {
+	case CompressionLevel::Fast:
+		return Z_BEST_SPEED;
+	case CompressionLevel::Best:
+		return Z_BEST_COMPRESSION;
+	default:
+		return Z_DEFAULT_COMPRESSION;
+	}
+}
+
+// zlib counts in uInt, so anything bigger is fed in several steps
+static uInt clampAvail(size_t size)
+{
+	return uInt(std::min(size, size_t(std::numeric_limits<uInt>::max())));
+}
+
+// zlib rejects a null output pointer even when there's no room to write, which empty spans and vectors give us
+static unsigned char* getOutPointer(gsl::span<gsl::byte> dst)
+{
+	static unsigned char dummy;
+	return dst.data() ? reinterpret_cast<unsigned char*>(dst.data()) : &dummy;
+}
+
+Compressor::Compressor(CompressionLevel level)
+	: stream(makeStream())
+	, level(level)
+{
+	if (deflateInit(stream.get(), getZlibLevel(level)) != Z_OK) {
+		throw Exception("Unable to initialize zlib compression", HalleyExceptions::Compression);
+	}
+}
+
+Compressor::~Compressor()
+{
+	deflateEnd(stream.get());
+}
+
+void Compressor::reset()
+{
+	if (dirty) {
+		deflateReset(stream.get());
+		dirty = false;
+	}
+}
+
+CompressionStepResult Compressor::update(gsl::span<const gsl::byte> src, gsl::span<gsl::byte> dst, bool finish)
+{
+	dirty = true;
+
+	const uInt inAvail = clampAvail(size_t(src.size_bytes()));
+	const uInt outAvail = clampAvail(size_t(dst.size_bytes()));
+	stream->avail_in = inAvail;
+	stream->next_in = reinterpret_cast<unsigned char*>(const_cast<gsl::byte*>(src.data()));
+	stream->avail_out = outAvail;
+	stream->next_out = getOutPointer(dst);
+
+	const bool lastInput = finish && size_t(inAvail) == size_t(src.size_bytes());
+	const int res = deflate(stream.get(), lastInput ? Z_FINISH : Z_NO_FLUSH);
+	if (res == Z_STREAM_ERROR) {
+		throw Exception("Unable to compress data.", HalleyExceptions::Compression);
+	}
+
+	CompressionStepResult result;
+	result.bytesRead = size_t(inAvail - stream->avail_in);
+	result.bytesWritten = size_t(outAvail - stream->avail_out);
+	result.finished = res == Z_STREAM_END;
+	return result;
+}
+
+size_t Compressor::compress(gsl::span<const gsl::byte> src, gsl::span<gsl::byte> dst)
+{
+	reset();
+
+	size_t read = 0;
+	size_t written = 0;
+	while (true) {
+		const auto step = update(src.subspan(read), dst.subspan(written), true);
+		read += step.bytesRead;
+		written += step.bytesWritten;
+		if (step.finished) {
+			return written;
+		}
+		if (step.bytesRead == 0 && step.bytesWritten == 0) {
+			throw Exception("Unable to compress data, output buffer is too small.", HalleyExceptions::Compression);
+		}
+	}
+}
+
+void Compressor::compress(gsl::span<const gsl::byte> src, Bytes& dst)
+{
+	reset();
+
+	// Start small and grow towards the worst case, rather than zero filling the worst case up front
+	const size_t start = dst.size();
+	const size_t bound = getMaxCompressedSize(size_t(src.size_bytes()));
+	dst.resize(start + std::min(bound, std::max(size_t(src.size_bytes()) / 4, size_t(256))));
+
+	size_t read = 0;
+	size_t written = 0;
+	while (true) {
+		const auto step = update(src.subspan(read), gsl::as_writeable_bytes(gsl::span<Byte>(dst)).subspan(start + written), true);
+		read += step.bytesRead;
+		written += step.bytesWritten;
+		if (step.finished) {
+			break;
+		}
+		if (start + written == dst.size()) {
+			dst.resize(start + std::max(bound, written * 2));
+		}
+	}
+
+	dst.resize(start + written);
+}
+
+size_t Compressor::getMaxCompressedSize(size_t srcSize)
+{
+	// Same as zlib's compressBound, which is safe for any level, but without the uLong truncation
+	return srcSize + (srcSize >> 12) + (srcSize >> 14) + (srcSize >> 25) + 13;
+}
+
+Compressor& Compressor::getThreadLocal(CompressionLevel level)
+{
+	thread_local std::array<std::unique_ptr<Compressor>, 3> compressors;
+	auto& compressor = compressors.at(size_t(level));
+	if (!compressor) {
+		compressor = std::make_unique<Compressor>(level);
+	}
+	return *compressor;
+}
+
+Decompressor::Decompressor()
+	: stream(makeStream())
+{
+	if (inflateInit(stream.get()) != Z_OK) {
+		throw Exception("Unable to initialise zlib", HalleyExceptions::Compression);
+	}
+}
+
+Decompressor::~Decompressor()
+{
+	inflateEnd(stream.get());
+}
+
+void Decompressor::reset()
+{
+	if (dirty) {
+		inflateReset(stream.get());
+		dirty = false;
+	}
+}
+
+CompressionStepResult Decompressor::update(gsl::span<const gsl::byte> src, gsl::span<gsl::byte> dst)
+{
+	dirty = true;
+
+	const uInt inAvail = clampAvail(size_t(src.size_bytes()));
+	const uInt outAvail = clampAvail(size_t(dst.size_bytes()));
+	stream->avail_in = inAvail;
+	stream->next_in = reinterpret_cast<unsigned char*>(const_cast<gsl::byte*>(src.data()));
+	stream->avail_out = outAvail;
+	stream->next_out = getOutPointer(dst);
+
+	const int res = inflate(stream.get(), Z_NO_FLUSH);
+	if (res != Z_OK && res != Z_STREAM_END && res != Z_BUF_ERROR) {
+		throw Exception("Unable to inflate stream.", HalleyExceptions::Compression);
+	}
+
+	CompressionStepResult result;
+	result.bytesRead = size_t(inAvail - stream->avail_in);
+	result.bytesWritten = size_t(outAvail - stream->avail_out);
+	result.finished = res == Z_STREAM_END;
+	return result;
+}
+
+size_t Decompressor::decompress(gsl::span<const gsl::byte> src, gsl::span<gsl::byte> dst)
+{
+	reset();
+
+	size_t read = 0;
+	size_t written = 0;
+	while (true) {
+		const auto step = update(src.subspan(read), dst.subspan(written));
+		read += step.bytesRead;
+		written += step.bytesWritten;
+		if (step.finished) {
+			return written;
+		}
+		if (step.bytesRead == 0 && step.bytesWritten == 0) {
+			if (written == size_t(dst.size_bytes())) {
+				throw Exception("Unable to inflate stream, it's larger than the expected " + toString(written) + " bytes.", HalleyExceptions::Compression);
+			}
+			throw Exception("Unable to inflate stream.", HalleyExceptions::Compression);
+		}
+	}
+}
+
+void Decompressor::decompress(gsl::span<const gsl::byte> src, Bytes& dst, size_t maxSize)
+{
+	reset();
+
+	constexpr size_t blockSize = 256 * 1024;
+	const size_t start = dst.size();
+
+	size_t read = 0;
+	size_t written = 0;
+	while (true) {
+		// Expand if needed
+		const size_t capacity = dst.size() - start;
+		if (capacity - written < blockSize / 2 && capacity < maxSize) {
+			dst.resize(start + std::min(capacity + blockSize, maxSize));
+		}
+
+		const auto step = update(src.subspan(read), gsl::as_writeable_bytes(gsl::span<Byte>(dst)).subspan(start + written));
+		read += step.bytesRead;
+		written += step.bytesWritten;
+		if (step.finished) {
+			break;
+		}
+		if (step.bytesRead == 0 && step.bytesWritten == 0) {
+			if (start + written == dst.size()) {
+				throw Exception("Unable to inflate stream, maximum size has been exceeded.", HalleyExceptions::Compression);
+			}
+			throw Exception("Unable to inflate stream.", HalleyExceptions::Compression);
+		}
+	}
+
+	dst.resize(start + written);
+}
+
+Decompressor& Decompressor::getThreadLocal()
+{
+	thread_local std::unique_ptr<Decompressor> decompressor;
+	if (!decompressor) {
+		decompressor = std::make_unique<Decompressor>();
+	}
+	return *decompressor;
+}
+
+Bytes Compression::compress(const Bytes& bytes, CompressionLevel level)
+{
+	return compress(gsl::as_bytes(gsl::span<const Byte>(bytes)), level);
+}
+
+Bytes Compression::compress(gsl::span<const gsl::byte> bytes, CompressionLevel level)
+{
+	return compressRaw(bytes, true, level);
 }
 
 Bytes Compression::decompress(const Bytes& bytes, size_t maxSize)
@@ -33,14 +285,31 @@ Bytes Compression::decompress(const Bytes& bytes, size_t maxSize)
 	return decompress(gsl::as_bytes(gsl::span<const Byte>(bytes)), maxSize);
 }
 
-Bytes Compression::decompress(gsl::span<const gsl::byte> bytes, size_t maxSize)
+static size_t readLengthHeader(gsl::span<const gsl::byte> bytes, size_t maxSize)
 {
 	Expects (sizeof(uint64_t) == 8);
 	Expects (bytes.size_bytes() >= 8);
 	uint64_t expectedOutSize;
 	memcpy(&expectedOutSize, bytes.data(), 8);
-	auto out = decompressRaw(bytes.subspan(8), maxSize, size_t(expectedOutSize));
-	return out;
+	if (expectedOutSize > uint64_t(maxSize)) {
+		throw Exception("File is too big to inflate: " + String::prettySize(expectedOutSize), HalleyExceptions::Compression);
+	}
+	return size_t(expectedOutSize);
+}
+
+static void checkOutSize(size_t outSize, size_t expectedSize)
+{
+	if (outSize != expectedSize) {
+		throw Exception("Unexpected outsize (" + toString(outSize) + ") when inflating data, expected (" + toString(expectedSize) + ").", HalleyExceptions::Compression);
+	}
+}
+
+Bytes Compression::decompress(gsl::span<const gsl::byte> bytes, size_t maxSize)
+{
+	const size_t expectedSize = readLengthHeader(bytes, maxSize);
+	Bytes result(expectedSize);
+	checkOutSize(Decompressor::getThreadLocal().decompress(bytes.subspan(8), gsl::as_writeable_bytes(gsl::span<Byte>(result))), expectedSize);
+	return result;
 }
 
 static void deleter(const char* data)
@@ -50,55 +319,37 @@ static void deleter(const char* data)
 
 std::shared_ptr<const char> Compression::decompressToSharedPtr(gsl::span<const gsl::byte> bytes, size_t& size, size_t maxSize)
 {
-	auto out = decompress(bytes, maxSize);
-	
-	size = out.size();
-	auto rawResult = new char[out.size()];
-	memcpy(rawResult, out.data(), out.size());
+	// Inflate straight into the final buffer, the length header tells us how big it has to be
+	const size_t expectedSize = readLengthHeader(bytes, maxSize);
+	auto rawResult = new char[expectedSize];
 	auto result = std::shared_ptr<const char>(rawResult, deleter);
+
+	const auto dst = gsl::span<gsl::byte>(reinterpret_cast<gsl::byte*>(rawResult), expectedSize);
+	checkOutSize(Decompressor::getThreadLocal().decompress(bytes.subspan(8), dst), expectedSize);
+
+	size = expectedSize;
 	return result;
 }
 
-Bytes Compression::compressRaw(gsl::span<const gsl::byte> bytes, bool insertLength)
+Bytes Compression::compressRaw(gsl::span<const gsl::byte> bytes, bool insertLength, CompressionLevel level)
 {
-	Expects (sizeof(uint64_t) == 8);
+	Bytes result;
+	compressRaw(bytes, result, insertLength, level);
+	return result;
+}
 
-	const uint64_t inSize = bytes.size_bytes();
-	const size_t headerSize = insertLength ? 8 : 0;
-	Bytes result(size_t(inSize) + headerSize + 16); // Header size, plus 16 bytes for headroom, should be enough for any compression
+void Compression::compressRaw(gsl::span<const gsl::byte> bytes, Bytes& out, bool insertLength, CompressionLevel level)
+{
+	Expects (sizeof(uint64_t) == 8);
 
 	if (insertLength) {
-		memcpy(result.data(), &inSize, 8);
-	}
-
-	z_stream stream;
-	stream.zalloc = &zlibAlloc;
-	stream.zfree = &zlibFree;
-	stream.opaque = nullptr;
-	int res = deflateInit(&stream, Z_DEFAULT_COMPRESSION);
-	if (res != Z_OK) {
-		throw Exception("Unable to initialize zlib compression", HalleyExceptions::Compression);
+		const uint64_t inSize = bytes.size_bytes();
+		const size_t pos = out.size();
+		out.resize(pos + 8);
+		memcpy(out.data() + pos, &inSize, 8);
 	}
 
-	stream.avail_in = uInt(bytes.size_bytes());
-	stream.next_in = reinterpret_cast<unsigned char*>(const_cast<gsl::byte*>(bytes.data()));
-	stream.avail_out = uInt(result.size() - headerSize);
-	stream.next_out = result.data() + headerSize;
-
-	do {
-		res = deflate(&stream, Z_FINISH);
-		if (res == Z_STREAM_ERROR || res == Z_BUF_ERROR) {
-			deflateEnd(&stream);
-			throw Exception("Unable to compress data.", HalleyExceptions::Compression);
-		}
-	} while (res != Z_STREAM_END);
-
-	const size_t outSize = size_t(stream.total_out);
-	deflateEnd(&stream);
-
-	result.resize(headerSize + outSize);
-	
-	return result;
+	Compressor::getThreadLocal(level).compress(bytes, out);
 }
 
 Bytes Compression::decompressRaw(gsl::span<const gsl::byte> bytes, size_t maxSize, size_t expectedSize)
@@ -106,65 +357,15 @@ Bytes Compression::decompressRaw(gsl::span<const gsl::byte> bytes, size_t maxSiz
 	if (expectedSize > uint64_t(maxSize)) {
 		throw Exception("File is too big to inflate: " + String::prettySize(expectedSize), HalleyExceptions::Compression);
 	}
-	
-	z_stream stream;
-	stream.zalloc = &zlibAlloc;
-	stream.zfree = &zlibFree;
-	stream.opaque = nullptr;
-	stream.avail_in = 0;
-	stream.next_in = nullptr;
-	int ret = inflateInit(&stream);
-	if (ret != Z_OK) {
-		throw Exception("Unable to initialise zlib", HalleyExceptions::Compression);
-	}
-	stream.avail_in = uInt(bytes.size_bytes());
-	stream.next_in = reinterpret_cast<unsigned char*>(const_cast<gsl::byte*>(bytes.data()));
 
+	auto& decompressor = Decompressor::getThreadLocal();
 	if (expectedSize > 0) {
 		Bytes result(expectedSize);
-		stream.avail_out = uInt(result.size());
-		stream.next_out = result.data();
-		
-		const int res = inflate(&stream, Z_NO_FLUSH);
-		const size_t totalOut = size_t(stream.total_out);
-		inflateEnd(&stream);
-
-		if (res != Z_STREAM_END) {
-			throw Exception("Unable to inflate stream.", HalleyExceptions::Compression);
-		}
-		if (totalOut != expectedSize) {
-			throw Exception("Unexpected outsize (" + toString(result.size()) + ") when inflating data, expected (" + toString(expectedSize) + ").", HalleyExceptions::Compression);
-		}
-
+		checkOutSize(decompressor.decompress(bytes, gsl::as_writeable_bytes(gsl::span<Byte>(result))), expectedSize);
 		return result;
 	} else {
-		constexpr size_t blockSize = 256 * 1024;
-		Bytes result(std::min(blockSize, maxSize));
-
-		int res = 0;
-		do {
-			// Expand if needed
-			if (result.size() - size_t(stream.total_out) < blockSize / 2) {
-				if (result.size() >= maxSize) {
-					inflateEnd(&stream);
-					throw Exception("Unable to inflate stream, maximum size has been exceeded.", HalleyExceptions::Compression);
-				}
-				auto newSize = std::min(result.size() + blockSize, maxSize);
-				result.resize(newSize);
-			}
-			stream.avail_out = uInt(result.size()) - stream.total_out;
-			stream.next_out = result.data() + size_t(stream.total_out);
-			res = inflate(&stream, Z_NO_FLUSH);
-		} while (res == Z_OK);
-
-		const size_t totalOut = size_t(stream.total_out);
-		inflateEnd(&stream);
-
-		if (res != Z_STREAM_END) {
-			throw Exception("Unable to inflate stream.", HalleyExceptions::Compression);
-		}
-		result.resize(totalOut);
-
+		Bytes result;
+		decompressor.decompress(bytes, result, maxSize);
 		return result;
 	}
 }
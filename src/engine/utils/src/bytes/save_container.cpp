@@ -0,0 +1,327 @@
+#include "halley/bytes/save_container.h"
+#include "halley/bytes/byte_serializer.h"
+#include "halley/bytes/compression.h"
+#include "halley/support/exception.h"
+#include "halley/utils/hash.h"
+#include "halley/text/string_converter.h"
+
+using namespace Halley;
+
+namespace {
+	constexpr const char* formatId = "HLLYSAVC";
+	constexpr uint32_t formatVersion = 1;
+	constexpr size_t fileHeaderSize = 24; // Format id, version, reserved, table size
+}
+
+void SaveContainer::TableEntry::serialize(Serializer& s) const
+{
+	s << name << encoding << offset << size << rawSize << rawHash;
+}
+
+void SaveContainer::TableEntry::deserialize(Deserializer& s)
+{
+	s >> name >> encoding >> offset >> size >> rawSize >> rawHash;
+}
+
+const Bytes& SaveContainer::Section::getData() const
+{
+	if (!data) {
+		auto src = gsl::as_bytes(gsl::span<const Byte>(*file)).subspan(offset, size);
+		auto result = Compression::decompressRaw(src, size_t(rawSize), size_t(rawSize));
+		if (Hash::hash(result) != rawHash) {
+			throw Exception("Save section is corrupted.", HalleyExceptions::File);
+		}
+		data = std::make_shared<const Bytes>(std::move(result));
+		file.reset();
+	}
+	return *data;
+}
+
+SaveContainer::SaveContainer() = default;
+
+void SaveContainer::setSection(const String& name, Bytes data)
+{
+	Section section;
+	section.rawSize = data.size();
+	section.rawHash = Hash::hash(data);
+	section.data = std::make_shared<const Bytes>(std::move(data));
+	sections[name] = std::move(section);
+}
+
+void SaveContainer::removeSection(const String& name)
+{
+	sections.erase(name);
+}
+
+bool SaveContainer::hasSection(const String& name) const
+{
+	return sections.find(name) != sections.end();
+}
+
+const Bytes& SaveContainer::getSection(const String& name) const
+{
+	const auto iter = sections.find(name);
+	if (iter == sections.end()) {
+		throw Exception("Save section not found: " + name, HalleyExceptions::File);
+	}
+	return iter->second.getData();
+}
+
+std::vector<String> SaveContainer::getSectionNames() const
+{
+	std::vector<String> result;
+	result.reserve(sections.size());
+	for (auto& s: sections) {
+		result.push_back(s.first);
+	}
+	return result;
+}
+
+uint64_t SaveContainer::getId() const
+{
+	Hash::Hasher hasher;
+	for (auto& s: sections) {
+		hasher.feedBytes(gsl::as_bytes(gsl::span<const char>(s.first.c_str(), s.first.size())));
+		hasher.feed(s.second.rawSize);
+		hasher.feed(s.second.rawHash);
+	}
+	const uint64_t id = hasher.digest();
+	return id == 0 ? 1 : id; // 0 is reserved for "no base"
+}
+
+Bytes SaveContainer::toBytes() const
+{
+	return write(nullptr);
+}
+
+Bytes SaveContainer::toDeltaBytes(const SaveContainer& base) const
+{
+	return write(&base);
+}
+
+SaveContainer SaveContainer::fromBytes(Bytes data)
+{
+	return read(std::move(data), nullptr);
+}
+
+SaveContainer SaveContainer::fromBytes(Bytes data, const SaveContainer& base)
+{
+	return read(std::move(data), &base);
+}
+
+uint64_t SaveContainer::getBaseId(gsl::span<const gsl::byte> data)
+{
+	if (size_t(data.size()) < fileHeaderSize || memcmp(data.data(), formatId, 8) != 0) {
+		throw Exception("Invalid save container.", HalleyExceptions::File);
+	}
+	uint64_t tableSize;
+	memcpy(&tableSize, data.data() + 16, 8);
+	if (tableSize > uint64_t(data.size()) - fileHeaderSize) {
+		throw Exception("Invalid save container.", HalleyExceptions::File);
+	}
+
+	uint64_t baseId;
+	Deserializer s(data.subspan(fileHeaderSize, size_t(tableSize)));
+	s >> baseId;
+	return baseId;
+}
+
+Bytes SaveContainer::write(const SaveContainer* base) const
+{
+	std::vector<TableEntry> table;
+	table.reserve(sections.size());
+	Bytes payload;
+
+	for (auto& s: sections) {
+		const Bytes& raw = s.second.getData();
+
+		TableEntry entry;
+		entry.name = s.first;
+		entry.rawSize = s.second.rawSize;
+		entry.rawHash = s.second.rawHash;
+
+		// Sections are compressed straight onto the end of the payload
+		entry.offset = payload.size();
+		bool done = false;
+		if (base) {
+			const auto baseIter = base->sections.find(s.first);
+			if (baseIter != base->sections.end()) {
+				const auto& baseSection = baseIter->second;
+				if (baseSection.rawHash == entry.rawHash && baseSection.rawSize == entry.rawSize) {
+					entry.encoding = Encoding::Unchanged;
+					done = true;
+				} else {
+					auto delta = makeDelta(baseSection.getData(), raw);
+					if (delta.size() < raw.size() / 2) {
+						entry.encoding = Encoding::Delta;
+						Compression::compressRaw(gsl::as_bytes(gsl::span<const Byte>(delta)), payload, false);
+						done = true;
+					}
+				}
+			}
+		}
+
+		if (!done) {
+			Compression::compressRaw(gsl::as_bytes(gsl::span<const Byte>(raw)), payload, false);
+			if (payload.size() - size_t(entry.offset) < raw.size()) {
+				entry.encoding = Encoding::Compressed;
+			} else {
+				entry.encoding = Encoding::Raw;
+				payload.resize(size_t(entry.offset));
+				payload.insert(payload.end(), raw.begin(), raw.end());
+			}
+		}
+
+		entry.size = payload.size() - size_t(entry.offset);
+		table.push_back(std::move(entry));
+	}
+
+	const uint64_t baseId = base ? base->getId() : 0;
+	const auto tableBytes = Serializer::toBytes([&] (Serializer& s)
+	{
+		s << baseId << table;
+	});
+
+	Bytes result(fileHeaderSize + tableBytes.size() + payload.size());
+	const uint32_t reserved = 0;
+	const uint64_t tableSize = tableBytes.size();
+	memcpy(result.data(), formatId, 8);
+	memcpy(result.data() + 8, &formatVersion, 4);
+	memcpy(result.data() + 12, &reserved, 4);
+	memcpy(result.data() + 16, &tableSize, 8);
+	memcpy(result.data() + fileHeaderSize, tableBytes.data(), tableBytes.size());
+	if (!payload.empty()) {
+		memcpy(result.data() + fileHeaderSize + tableBytes.size(), payload.data(), payload.size());
+	}
+	return result;
+}
+
+SaveContainer SaveContainer::read(Bytes data, const SaveContainer* base)
+{
+	const auto span = gsl::as_bytes(gsl::span<const Byte>(data));
+	const uint64_t expectedBaseId = getBaseId(span);
+
+	uint32_t version;
+	memcpy(&version, data.data() + 8, 4);
+	if (version > formatVersion) {
+		throw Exception("Save container version " + toString(version) + " is not supported.", HalleyExceptions::File);
+	}
+
+	if (expectedBaseId != 0) {
+		if (!base) {
+			throw Exception("Save container is a delta, but no base was provided.", HalleyExceptions::File);
+		}
+		if (base->getId() != expectedBaseId) {
+			throw Exception("Save container delta does not match the provided base.", HalleyExceptions::File);
+		}
+	}
+
+	uint64_t tableSize;
+	memcpy(&tableSize, data.data() + 16, 8);
+	uint64_t baseId;
+	std::vector<TableEntry> table;
+	Deserializer s(span.subspan(fileHeaderSize, size_t(tableSize)));
+	s >> baseId >> table;
+
+	const size_t payloadStart = fileHeaderSize + size_t(tableSize);
+	const size_t payloadSize = data.size() - payloadStart;
+	auto file = std::make_shared<const Bytes>(std::move(data));
+	const auto payload = gsl::as_bytes(gsl::span<const Byte>(*file)).subspan(payloadStart);
+
+	SaveContainer result;
+	for (auto& entry: table) {
+		if (entry.offset > payloadSize || entry.size > payloadSize - entry.offset) {
+			throw Exception("Save section \"" + entry.name + "\" is out of bounds.", HalleyExceptions::File);
+		}
+		const auto stored = payload.subspan(size_t(entry.offset), size_t(entry.size));
+
+		Section section;
+		section.rawSize = entry.rawSize;
+		section.rawHash = entry.rawHash;
+
+		switch (entry.encoding) {
+		case Encoding::Raw:
+			section.data = std::make_shared<const Bytes>(reinterpret_cast<const Byte*>(stored.data()), reinterpret_cast<const Byte*>(stored.data()) + stored.size());
+			break;
+
+		case Encoding::Compressed:
+			// Inflated on first access
+			section.file = file;
+			section.offset = payloadStart + size_t(entry.offset);
+			section.size = size_t(entry.size);
+			break;
+
+		case Encoding::Unchanged:
+		case Encoding::Delta:
+			{
+				const auto baseIter = base ? base->sections.find(entry.name) : std::map<String, Section>::const_iterator();
+				if (!base || baseIter == base->sections.end()) {
+					throw Exception("Save section \"" + entry.name + "\" is missing from the base.", HalleyExceptions::File);
+				}
+				if (entry.encoding == Encoding::Unchanged) {
+					section = baseIter->second;
+				} else {
+					const size_t maxDeltaSize = size_t(entry.rawSize) * 2 + 64;
+					const auto delta = Compression::decompressRaw(stored, maxDeltaSize);
+					section.data = std::make_shared<const Bytes>(applyDelta(baseIter->second.getData(), gsl::as_bytes(gsl::span<const Byte>(delta)), size_t(entry.rawSize)));
+				}
+			}
+			break;
+
+		default:
+			throw Exception("Unknown encoding on save section \"" + entry.name + "\".", HalleyExceptions::File);
+		}
+
+		if (section.data && Hash::hash(*section.data) != section.rawHash) {
+			throw Exception("Save section \"" + entry.name + "\" is corrupted.", HalleyExceptions::File);
+		}
+
+		result.sections[entry.name] = std::move(section);
+	}
+
+	return result;
+}
+
+Bytes SaveContainer::makeDelta(const Bytes& base, const Bytes& data)
+{
+	std::vector<uint32_t> changedBlocks;
+	const size_t nBlocks = (data.size() + deltaBlockSize - 1) / deltaBlockSize;
+	for (size_t i = 0; i < nBlocks; ++i) {
+		const size_t start = i * deltaBlockSize;
+		const size_t len = std::min(deltaBlockSize, data.size() - start);
+		if (start + len > base.size() || memcmp(base.data() + start, data.data() + start, len) != 0) {
+			changedBlocks.push_back(uint32_t(i));
+		}
+	}
+
+	return Serializer::toBytes([&] (Serializer& s)
+	{
+		s << changedBlocks;
+		for (auto i: changedBlocks) {
+			const size_t start = i * deltaBlockSize;
+			const size_t len = std::min(deltaBlockSize, data.size() - start);
+			s << gsl::as_bytes(gsl::span<const Byte>(data.data() + start, len));
+		}
+	});
+}
+
+Bytes SaveContainer::applyDelta(const Bytes& base, gsl::span<const gsl::byte> delta, size_t rawSize)
+{
+	Bytes result(rawSize);
+	memcpy(result.data(), base.data(), std::min(base.size(), rawSize));
+
+	std::vector<uint32_t> changedBlocks;
+	Deserializer s(delta);
+	s >> changedBlocks;
+	for (auto i: changedBlocks) {
+		const size_t start = size_t(i) * deltaBlockSize;
+		if (start >= rawSize) {
+			throw Exception("Save section delta is out of bounds.", HalleyExceptions::File);
+		}
+		const size_t len = std::min(deltaBlockSize, rawSize - start);
+		auto dst = gsl::as_writeable_bytes(gsl::span<Byte>(result.data() + start, len));
+		s >> dst;
+	}
+
+	return result;
+}
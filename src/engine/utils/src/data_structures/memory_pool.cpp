@@ -3,18 +3,41 @@
 
 using namespace Halley;
 
-PoolPool& PoolPool::get()
+PoolPool::PoolPool()
 {
-	static PoolPool* pools = nullptr;
-	if (!pools) {
-		pools = new PoolPool();
+	for (auto& p: directPools) {
+		p.store(nullptr, std::memory_order_relaxed);
 	}
+}
+
+PoolPool& PoolPool::get()
+{
+	// Never destroyed, as blocks (and thread caches) may outlive static destruction
+	static PoolPool* pools = new PoolPool();
 	return *pools;
 }
 
 SizePool* PoolPool::getPool(size_t size)
 {
-	auto& pools = get().pools;
+	auto& self = get();
+
+	if (size <= maxDirectSize) {
+		auto& slot = self.directPools[size];
+		SizePool* pool = slot.load(std::memory_order_acquire);
+		if (!pool) {
+			// Racing threads may both create a pool, only one gets published
+			auto newPool = new SizePool(size);
+			if (slot.compare_exchange_strong(pool, newPool, std::memory_order_acq_rel, std::memory_order_acquire)) {
+				pool = newPool;
+			} else {
+				delete newPool;
+			}
+		}
+		return pool;
+	}
+
+	std::unique_lock<std::mutex> lock(self.mutex);
+	auto& pools = self.pools;
 	auto iter = pools.find(size);
 	if (iter != pools.end()) {
 		return iter->second;
@@ -27,8 +50,12 @@ SizePool* PoolPool::getPool(size_t size)
 
 typedef boost::pool<boost::default_user_allocator_malloc_free> PoolType;
 
+static std::atomic<size_t> nextPoolIndex(0);
+static thread_local bool threadCachesDestroyed = false; // Trivially destructible, so it can still be read during thread and program shutdown
+
 SizePool::SizePool(size_t size)
 	: size(size)
+	, index(nextPoolIndex++)
 {
 	pimpl = new PoolType(size);
 }
@@ -40,10 +67,87 @@ SizePool::~SizePool()
 
 void* SizePool::alloc()
 {
-	return reinterpret_cast<PoolType*>(pimpl)->malloc();
+	auto cache = getThreadCache();
+	if (!cache) {
+		std::unique_lock<std::mutex> lock(mutex);
+		return reinterpret_cast<PoolType*>(pimpl)->malloc();
+	}
+
+	if (cache->count == 0) {
+		refill(*cache, threadCacheSize / 2);
+		if (cache->count == 0) {
+			return nullptr;
+		}
+	}
+	return cache->blocks[--cache->count];
 }
 
 void SizePool::free(void* p)
 {
-	reinterpret_cast<PoolType*>(pimpl)->free(p);
+	if (!p) {
+		return;
+	}
+
+	auto cache = getThreadCache();
+	if (!cache) {
+		std::unique_lock<std::mutex> lock(mutex);
+		reinterpret_cast<PoolType*>(pimpl)->free(p);
+		return;
+	}
+
+	if (cache->count == threadCacheSize) {
+		release(*cache, threadCacheSize / 2);
+	}
+	cache->blocks[cache->count++] = p;
+}
+
+SizePool::ThreadCache* SizePool::getThreadCache()
+{
+	// Objects freed by static destructors can arrive after this thread's caches are gone
+	if (threadCachesDestroyed) {
+		return nullptr;
+	}
+
+	thread_local ThreadCaches threadCaches;
+	auto& caches = threadCaches.caches;
+	if (index >= caches.size()) {
+		caches.resize(index + 1);
+	}
+	auto& cache = caches[index];
+	cache.pool = this;
+	return &cache;
+}
+
+void SizePool::refill(ThreadCache& cache, size_t n)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	auto& pool = *reinterpret_cast<PoolType*>(pimpl);
+	for (size_t i = 0; i < n; ++i) {
+		void* p = pool.malloc();
+		if (!p) {
+			break;
+		}
+		cache.blocks[cache.count++] = p;
+	}
+}
+
+void SizePool::release(ThreadCache& cache, size_t n)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	auto& pool = *reinterpret_cast<PoolType*>(pimpl);
+	for (size_t i = 0; i < n && cache.count > 0; ++i) {
+		pool.free(cache.blocks[--cache.count]);
+	}
+}
+
+SizePool::ThreadCaches::~ThreadCaches()
+{
+	threadCachesDestroyed = true;
+
+	// Hand cached blocks back, so they can be reused by other threads
+	for (auto& cache: caches) {
+		if (cache.pool && cache.count > 0) {
+			cache.pool->release(cache, cache.count);
+		}
+	}
 }
@@ -23,6 +23,7 @@
 #include "halley/file_formats/image.h"
 #include "../../contrib/stb_image/stb_image.h"
 #include "../../contrib/lodepng/lodepng.h"
+#include "../../contrib/zlib/zlib.h"
 #include "halley/support/exception.h"
 #include "halley/resources/resource_data.h"
 #include "halley/text/string_converter.h"
@@ -457,7 +458,53 @@ int Image::getPixelAlpha(Vector2i pos) const
 	return pixel >> 24;
 }
 
-Bytes Image::savePNGToBytes(bool allowDepthReduce) const
+static voidpf zlibAlloc(voidpf opaque, uInt items, uInt size)
+{
+	return malloc(size_t(items * size));
+}
+
+static void zlibFree(voidpf opaque, voidpf address)
+{
+	free(address);
+}
+
+static unsigned fastZlibCompress(unsigned char** out, size_t* outSize, const unsigned char* in, size_t inSize, const LodePNGCompressSettings*)
+{
+	// lodepng's own deflate is tuned for size and is very slow on large images, so hand it to zlib at its fastest level instead
+	z_stream stream;
+	stream.zalloc = &zlibAlloc;
+	stream.zfree = &zlibFree;
+	stream.opaque = nullptr;
+	if (deflateInit(&stream, Z_BEST_SPEED) != Z_OK) {
+		return 111; // lodepng's "unknown error"
+	}
+
+	const size_t bound = size_t(deflateBound(&stream, uLong(inSize)));
+	auto buffer = static_cast<unsigned char*>(malloc(bound));
+	if (!buffer) {
+		deflateEnd(&stream);
+		return 83; // lodepng's "memory allocation failed"
+	}
+
+	stream.avail_in = uInt(inSize);
+	stream.next_in = const_cast<unsigned char*>(in);
+	stream.avail_out = uInt(bound);
+	stream.next_out = buffer;
+	const int res = deflate(&stream, Z_FINISH);
+	const size_t size = size_t(stream.total_out);
+	deflateEnd(&stream);
+
+	if (res != Z_STREAM_END) {
+		free(buffer);
+		return 111;
+	}
+
+	*out = buffer;
+	*outSize = size;
+	return 0;
+}
+
+Bytes Image::savePNGToBytes(bool allowDepthReduce, PNGEncoding encoding) const
 {
 	unsigned char* bytes;
 	size_t size;
@@ -482,6 +529,16 @@ Bytes Image::savePNGToBytes(bool allowDepthReduce) const
 	state.info_png.color.colortype = colFormat;
 	state.info_png.color.bitdepth = 8;
 	state.encoder.auto_convert = allowDepthReduce ? 1 : 0;
+
+	std::vector<unsigned char> filters;
+	if (encoding == PNGEncoding::Fast) {
+		// Single pass: always use the "up" filter instead of trying all five per scanline, and deflate with zlib
+		filters.resize(h, 2);
+		state.encoder.filter_strategy = LFS_PREDEFINED;
+		state.encoder.predefined_filters = filters.data();
+		state.encoder.zlibsettings.custom_zlib = &fastZlibCompress;
+	}
+
 	lodepng_encode(&bytes, &size, reinterpret_cast<unsigned char*>(px.get()), w, h, &state);
 	auto errorCode = state.error;
 	lodepng_state_cleanup(&state);
@@ -20,7 +20,14 @@
 \*****************************************************************/
 
 #include <cstring>
+#include <cmath>
 #include "halley/maths/matrix4.h"
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) || defined(__i386)
+#define HAS_SSE
+#include <xmmintrin.h>
+#endif
+
 using namespace Halley;
 
 Matrix4f::Matrix4f()
@@ -57,6 +64,21 @@ Matrix4f& Matrix4f::operator*=(const Matrix4f& param)
 Matrix4f Matrix4f::operator*(const Matrix4f& param) const
 {
 	Matrix4f result;
+#ifdef HAS_SSE
+	// Each column of the result is a linear combination of this matrix's columns
+	const __m128 c0 = _mm_loadu_ps(&elements[0]);
+	const __m128 c1 = _mm_loadu_ps(&elements[4]);
+	const __m128 c2 = _mm_loadu_ps(&elements[8]);
+	const __m128 c3 = _mm_loadu_ps(&elements[12]);
+	for (size_t x = 0; x < 4; x++) {
+		const float* p = &param.elements[4 * x];
+		__m128 col = _mm_mul_ps(c0, _mm_set1_ps(p[0]));
+		col = _mm_add_ps(col, _mm_mul_ps(c1, _mm_set1_ps(p[1])));
+		col = _mm_add_ps(col, _mm_mul_ps(c2, _mm_set1_ps(p[2])));
+		col = _mm_add_ps(col, _mm_mul_ps(c3, _mm_set1_ps(p[3])));
+		_mm_storeu_ps(&result.elements[4 * x], col);
+	}
+#else
 	for (size_t y = 0; y < 4; y++) {
 		for (size_t x = 0; x < 4; x++) {
 			float accum = 0.0f;
@@ -66,6 +88,7 @@ Matrix4f Matrix4f::operator*(const Matrix4f& param) const
 			result.getElement(x, y) = accum;
 		}
 	}
+#endif
 	return result;
 }
 
@@ -83,6 +106,122 @@ Vector2f Matrix4f::operator*(const Vector2f& param) const
 	return Vector2f(result[0] / result[3], result[1] / result[3]);
 }
 
+void Matrix4f::transformPoints(gsl::span<Vector2f> points) const
+{
+	transformPoints(points, points);
+}
+
+void Matrix4f::transformPoints(gsl::span<const Vector2f> src, gsl::span<Vector2f> dst) const
+{
+	Expects(src.size() == dst.size());
+	static_assert(sizeof(Vector2f) == 2 * sizeof(float), "Vector2f must be tightly packed");
+
+	const auto& e = elements;
+	const size_t n = size_t(src.size());
+	const bool affine = isAffine2D();
+	size_t i = 0;
+
+#ifdef HAS_SSE
+	const __m128 m00 = _mm_set1_ps(e[0]);
+	const __m128 m01 = _mm_set1_ps(e[1]);
+	const __m128 m03 = _mm_set1_ps(e[3]);
+	const __m128 m10 = _mm_set1_ps(e[4]);
+	const __m128 m11 = _mm_set1_ps(e[5]);
+	const __m128 m13 = _mm_set1_ps(e[7]);
+	const __m128 m30 = _mm_set1_ps(e[12]);
+	const __m128 m31 = _mm_set1_ps(e[13]);
+	const __m128 m33 = _mm_set1_ps(e[15]);
+
+	for (; i + 4 <= n; i += 4) {
+		const float* in = &src[i].x;
+		float* out = &dst[i].x;
+
+		// Deinterleave x0 y0 x1 y1 | x2 y2 x3 y3 into xxxx and yyyy
+		const __m128 a = _mm_loadu_ps(in);
+		const __m128 b = _mm_loadu_ps(in + 4);
+		const __m128 x = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+		const __m128 y = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+
+		__m128 rx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, x), _mm_mul_ps(m10, y)), m30);
+		__m128 ry = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m01, x), _mm_mul_ps(m11, y)), m31);
+		if (!affine) {
+			const __m128 rw = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m03, x), _mm_mul_ps(m13, y)), m33);
+			rx = _mm_div_ps(rx, rw);
+			ry = _mm_div_ps(ry, rw);
+		}
+
+		_mm_storeu_ps(out, _mm_unpacklo_ps(rx, ry));
+		_mm_storeu_ps(out + 4, _mm_unpackhi_ps(rx, ry));
+	}
+#endif
+
+	for (; i < n; ++i) {
+		const Vector2f p = src[i];
+		const float rx = e[0] * p.x + e[4] * p.y + e[12];
+		const float ry = e[1] * p.x + e[5] * p.y + e[13];
+		if (affine) {
+			dst[i] = Vector2f(rx, ry);
+		} else {
+			const float rw = e[3] * p.x + e[7] * p.y + e[15];
+			dst[i] = Vector2f(rx / rw, ry / rw);
+		}
+	}
+}
+
+bool Matrix4f::isAffine2D() const
+{
+	return elements[3] == 0.0f && elements[7] == 0.0f && elements[15] == 1.0f;
+}
+
+Matrix4f Matrix4f::inverted() const
+{
+	// Cofactor expansion, using 2x2 sub-determinants shared between the cofactors
+	const auto& m = elements;
+
+	const float s0 = m[0] * m[5] - m[4] * m[1];
+	const float s1 = m[0] * m[6] - m[4] * m[2];
+	const float s2 = m[0] * m[7] - m[4] * m[3];
+	const float s3 = m[1] * m[6] - m[5] * m[2];
+	const float s4 = m[1] * m[7] - m[5] * m[3];
+	const float s5 = m[2] * m[7] - m[6] * m[3];
+
+	const float c5 = m[10] * m[15] - m[14] * m[11];
+	const float c4 = m[9] * m[15] - m[13] * m[11];
+	const float c3 = m[9] * m[14] - m[13] * m[10];
+	const float c2 = m[8] * m[15] - m[12] * m[11];
+	const float c1 = m[8] * m[14] - m[12] * m[10];
+	const float c0 = m[8] * m[13] - m[12] * m[9];
+
+	const float det = s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0;
+	if (std::abs(det) < 1e-12f) {
+		return makeIdentity();
+	}
+	const float invDet = 1.0f / det;
+
+	Matrix4f result;
+	auto& r = result.elements;
+	r[0] = ( m[5] * c5 - m[6] * c4 + m[7] * c3) * invDet;
+	r[1] = (-m[1] * c5 + m[2] * c4 - m[3] * c3) * invDet;
+	r[2] = ( m[13] * s5 - m[14] * s4 + m[15] * s3) * invDet;
+	r[3] = (-m[9] * s5 + m[10] * s4 - m[11] * s3) * invDet;
+
+	r[4] = (-m[4] * c5 + m[6] * c2 - m[7] * c1) * invDet;
+	r[5] = ( m[0] * c5 - m[2] * c2 + m[3] * c1) * invDet;
+	r[6] = (-m[12] * s5 + m[14] * s2 - m[15] * s1) * invDet;
+	r[7] = ( m[8] * s5 - m[10] * s2 + m[11] * s1) * invDet;
+
+	r[8] = ( m[4] * c4 - m[5] * c2 + m[7] * c0) * invDet;
+	r[9] = (-m[0] * c4 + m[1] * c2 - m[3] * c0) * invDet;
+	r[10] = ( m[12] * s4 - m[13] * s2 + m[15] * s0) * invDet;
+	r[11] = (-m[8] * s4 + m[9] * s2 - m[11] * s0) * invDet;
+
+	r[12] = (-m[4] * c3 + m[5] * c1 - m[6] * c0) * invDet;
+	r[13] = ( m[0] * c3 - m[1] * c1 + m[2] * c0) * invDet;
+	r[14] = (-m[12] * s3 + m[13] * s1 - m[14] * s0) * invDet;
+	r[15] = ( m[8] * s3 - m[9] * s1 + m[10] * s0) * invDet;
+	return result;
+}
+
 void Matrix4f::loadIdentity()
 {
 	const static float identityMatrix[] =  {1.0f, 0.0f, 0.0f, 0.0f,
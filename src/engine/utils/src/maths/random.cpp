@@ -23,22 +23,61 @@
 #include <cstring>
 #include <ctime>
 #include <cstdlib>
-#include "mt199937ar.h"
+#include <mutex>
 using namespace Halley;
 
+namespace {
+	inline uint64_t rotl(uint64_t x, int k)
+	{
+		return (x << k) | (x >> (64 - k));
+	}
+
+	inline uint64_t splitMix64(uint64_t& x)
+	{
+		uint64_t z = (x += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	inline uint64_t next(std::array<uint64_t, 4>& s)
+	{
+		const uint64_t result = rotl(s[1] * 5, 7) * 9;
+		const uint64_t t = s[1] << 17;
+		s[2] ^= s[0];
+		s[3] ^= s[1];
+		s[1] ^= s[2];
+		s[0] ^= s[3];
+		s[2] ^= t;
+		s[3] = rotl(s[3], 45);
+		return result;
+	}
+
+	inline float toUnitFloat(uint64_t x)
+	{
+		return float(x >> 40) * (1.0f / 16777216.0f); // 24 bits of mantissa
+	}
+
+	inline uint32_t toRange(uint32_t x, uint32_t range)
+	{
+		// Multiply-shift instead of modulo; same bias as modulo, no division
+		return uint32_t((uint64_t(x) * uint64_t(range)) >> 32);
+	}
+
+	std::mutex seedMutex;
+}
+
 Random::Random()
-	: generator(std::make_unique<MT199937AR>())
 {
+	setSeed(0);
 }
 
 Random::Random(uint32_t seed)
-	: generator(std::make_unique<MT199937AR>())
 {
 	setSeed(seed);
 }
 
 Random::Random(gsl::span<const gsl::byte> data)
-	: generator(std::make_unique<MT199937AR>())
 {
 	setSeed(data);
 }
@@ -59,7 +98,7 @@ int32_t Random::getInt(int32_t min, int32_t max)
 	if (range == 0) { // If min and max correspond to the whole range represented, this blows up
 		return int32_t(base);
 	}
-	return int32_t(base % range) + min;
+	return int32_t(toRange(base, range)) + min;
 }
 
 uint32_t Random::getInt(uint32_t min, uint32_t max)
@@ -72,7 +111,7 @@ uint32_t Random::getInt(uint32_t min, uint32_t max)
 	if (range == 0) { // If min and max correspond to the whole range represented, this blows up
 		return base;
 	}
-	return base % range + min;
+	return toRange(base, range) + min;
 }
 
 int64_t Random::getInt(int64_t min, int64_t max)
@@ -80,12 +119,12 @@ int64_t Random::getInt(int64_t min, int64_t max)
 	if (min > max) {
 		std::swap(min, max);
 	}
-	const int64_t base = int64_t((uint64_t(getRawInt()) << 32ull) | uint64_t(getRawInt()));
+	const int64_t base = int64_t(getRawInt64());
 	const uint64_t range = uint64_t(max - min + 1);
 	if (range == 0) { // If min and max correspond to the whole range represented, this blows up
 		return int64_t(base);
 	}
-	return int64_t(base % range) + min;
+	return int64_t(uint64_t(base) % range) + min;
 }
 
 uint64_t Random::getInt(uint64_t min, uint64_t max)
@@ -93,7 +132,7 @@ uint64_t Random::getInt(uint64_t min, uint64_t max)
 	if (min > max) {
 		std::swap(min, max);
 	}
-	const uint64_t base = (uint64_t(getRawInt()) << 32ull) | uint64_t(getRawInt());
+	const uint64_t base = getRawInt64();
 	const uint64_t range = max - min + 1;
 	if (range == 0) { // If min and max correspond to the whole range represented, this blows up
 		return base;
@@ -116,60 +155,148 @@ double Random::getDouble(double min, double max)
 	return getRawDouble() * (max - min) + min;
 }
 
+static Random makeTimeSeeded(int salt)
+{
+	time_t curTime = time(nullptr);
+	int curClock = int(clock());
+	int seed[] = { int(curTime & 0xFFFFFFFF), int(static_cast<long long>(curTime) >> 32), curClock, salt };
+	return Random(gsl::as_bytes(gsl::span<char>(reinterpret_cast<char*>(seed), sizeof(seed))));
+}
+
 Random& Random::getGlobal()
 {
-	static Random* global = nullptr;
-	if (!global) {
-		time_t curTime = time(nullptr);
-		int curClock = int(clock());
-		int salt = 0x3F29AB51;
-		int seed[] = { int(curTime & 0xFFFFFFFF), int(static_cast<long long>(curTime) >> 32), curClock, salt };
-		global = new Random(gsl::as_bytes(gsl::span<char>(reinterpret_cast<char*>(seed), sizeof(seed))));
-	}
-	return *global;
+	static Random global = makeTimeSeeded(0x3F29AB51);
+	return global;
+}
+
+Random& Random::getThreadLocal()
+{
+	thread_local Random local = [] ()
+	{
+		// Split from a generator of our own, as getGlobal() may be in use on another thread
+		std::unique_lock<std::mutex> lock(seedMutex);
+		static Random seeder = makeTimeSeeded(0x5A17C0DE);
+		return seeder.split();
+	}();
+	return local;
 }
 
 void Random::getBytes(gsl::span<gsl::byte> dst)
 {
-	int step = 0;
-	uint32_t number = getRawInt();
+	const size_t size = size_t(dst.size_bytes());
+	size_t pos = 0;
+	for (; pos + 8 <= size; pos += 8) {
+		const uint64_t number = next(state);
+		memcpy(dst.data() + pos, &number, 8);
+	}
+	if (pos < size) {
+		const uint64_t number = next(state);
+		memcpy(dst.data() + pos, &number, size - pos);
+	}
+}
 
-	for (int pos = 0; pos < dst.size_bytes(); ++pos) {
-		dst[pos] = gsl::byte(uint8_t(number & 0xFF));
+void Random::setSeed(uint32_t seed)
+{
+	uint64_t x = seed;
+	for (auto& s: state) {
+		s = splitMix64(x);
+	}
+}
 
-		number >>= 8;
-		++step;
-		if (step == 4) {
-			number = getRawInt();
-			step = 0;
+void Random::setSeed(gsl::span<const gsl::byte> data)
+{
+	// Fold the data into a single 64-bit value, then expand it into the state
+	uint64_t x = 0;
+	for (size_t pos = 0; pos < size_t(data.size_bytes()); pos += 8) {
+		uint64_t word = 0;
+		memcpy(&word, data.data() + pos, std::min(size_t(8), size_t(data.size_bytes()) - pos));
+		x ^= word;
+		x = splitMix64(x);
+	}
+	for (auto& s: state) {
+		s = splitMix64(x);
+	}
+}
+
+void Random::getFloats(gsl::span<float> dst, float min, float max)
+{
+	const float range = max - min;
+	auto s = state;
+	for (auto& v: dst) {
+		v = toUnitFloat(next(s)) * range + min;
+	}
+	state = s;
+}
+
+void Random::getInts(gsl::span<int32_t> dst, int32_t min, int32_t max)
+{
+	if (min > max) {
+		std::swap(min, max);
+	}
+	const uint32_t range = uint32_t(max - min + 1);
+	auto s = state;
+	if (range == 0) {
+		for (auto& v: dst) {
+			v = int32_t(next(s) >> 32);
+		}
+	} else {
+		for (auto& v: dst) {
+			v = int32_t(toRange(uint32_t(next(s) >> 32), range)) + min;
 		}
 	}
+	state = s;
 }
 
-void Random::setSeed(uint32_t seed)
+void Random::jump()
 {
-	 generator->init_genrand(seed);
+	doJump({{ 0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull }});
 }
 
-void Random::setSeed(gsl::span<const gsl::byte> data)
+void Random::longJump()
+{
+	doJump({{ 0x76E15D3EFEFDCBBFull, 0xC5004E441C522FB3ull, 0x77710069854EE241ull, 0x39109BB02ACBE635ull }});
+}
+
+Random Random::split()
+{
+	Random result;
+	result.state = state;
+	jump();
+	return result;
+}
+
+void Random::doJump(const std::array<uint64_t, 4>& polynomial)
 {
-	std::vector<uint32_t> initData(alignUp(size_t(data.size_bytes()), sizeof(uint32_t)) / sizeof(uint32_t), 0);
-	memcpy(initData.data(), data.data(), data.size_bytes());
-	generator->init_by_array(initData.data(), initData.size());
+	std::array<uint64_t, 4> result = {{ 0, 0, 0, 0 }};
+	for (auto p: polynomial) {
+		for (int b = 0; b < 64; ++b) {
+			if (p & (uint64_t(1) << b)) {
+				for (size_t i = 0; i < 4; ++i) {
+					result[i] ^= state[i];
+				}
+			}
+			next(state);
+		}
+	}
+	state = result;
 }
 
 uint32_t Random::getRawInt()
 {
-	return generator->genrand_int32();
+	return uint32_t(next(state) >> 32);
+}
+
+uint64_t Random::getRawInt64()
+{
+	return next(state);
 }
 
 float Random::getRawFloat()
 {
-	return float(generator->genrand_real2());
+	return toUnitFloat(next(state));
 }
 
 double Random::getRawDouble()
 {
-	return generator->genrand_res53();
+	return double(next(state) >> 11) * (1.0 / 9007199254740992.0);
 }
-
@@ -0,0 +1,295 @@
+#include "halley/support/memory_tracker.h"
+#include "halley/support/stats.h"
+#include "halley/text/string_converter.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <sstream>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#pragma intrinsic(_ReturnAddress)
+#define HALLEY_RETURN_ADDRESS() _ReturnAddress()
+#else
+#define HALLEY_RETURN_ADDRESS() __builtin_return_address(0)
+#endif
+
+using namespace Halley;
+
+namespace {
+	constexpr size_t numTags = size_t(MemoryTag::NUMBER_OF_TAGS);
+
+	struct TagCounters
+	{
+		std::atomic<int64_t> liveBytes;
+		std::atomic<int64_t> liveAllocations;
+		std::atomic<int64_t> totalBytes;
+		std::atomic<int64_t> totalAllocations;
+	};
+
+	// Fixed size open addressing table, since it's updated from inside operator new and must not allocate
+	struct CallSiteTable
+	{
+		constexpr static size_t capacity = 512;
+		std::array<MemoryCallSite, capacity> entries;
+
+		void add(const void* address, int64_t allocations, int64_t bytes)
+		{
+			size_t idx = (reinterpret_cast<uintptr_t>(address) >> 2) % capacity;
+			for (size_t i = 0; i < capacity; ++i) {
+				auto& e = entries[(idx + i) % capacity];
+				if (e.address == address || e.address == nullptr) {
+					e.address = address;
+					e.allocations += allocations;
+					e.bytes += bytes;
+					return;
+				}
+			}
+		}
+	};
+
+	TagCounters counters[numTags];
+	CallSiteTable callSites[numTags];
+	std::mutex callSiteMutex;
+
+	thread_local MemoryTag currentTag = MemoryTag::Untagged;
+
+#ifdef HALLEY_TRACK_ALLOCATIONS
+	constexpr uint32_t callSiteSampleRate = 64; // Each sample stands for this many allocations
+	thread_local uint32_t sampleCounter = 0;
+
+	// Prepended to each allocation, so delete knows which tag to charge. Keeps the default new alignment.
+	struct alignas(16) AllocationHeader
+	{
+		size_t size;
+		MemoryTag tag;
+	};
+
+	void* trackedAlloc(size_t size, const void* caller) noexcept
+	{
+		auto* header = static_cast<AllocationHeader*>(malloc(size + sizeof(AllocationHeader)));
+		if (!header) {
+			return nullptr;
+		}
+
+		const MemoryTag tag = currentTag;
+		header->size = size;
+		header->tag = tag;
+
+		auto& c = counters[size_t(tag)];
+		c.liveBytes.fetch_add(int64_t(size), std::memory_order_relaxed);
+		c.liveAllocations.fetch_add(1, std::memory_order_relaxed);
+		c.totalBytes.fetch_add(int64_t(size), std::memory_order_relaxed);
+		c.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+
+		if (++sampleCounter == callSiteSampleRate) {
+			sampleCounter = 0;
+			std::unique_lock<std::mutex> lock(callSiteMutex);
+			callSites[size_t(tag)].add(caller, callSiteSampleRate, int64_t(size) * callSiteSampleRate);
+		}
+
+		return header + 1;
+	}
+
+	void trackedFree(void* ptr) noexcept
+	{
+		if (!ptr) {
+			return;
+		}
+
+		auto* header = static_cast<AllocationHeader*>(ptr) - 1;
+		auto& c = counters[size_t(header->tag)];
+		c.liveBytes.fetch_sub(int64_t(header->size), std::memory_order_relaxed);
+		c.liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+		free(header);
+	}
+
+	void* trackedAllocOrThrow(size_t size, const void* caller)
+	{
+		void* result = trackedAlloc(size, caller);
+		if (!result) {
+			throw std::bad_alloc();
+		}
+		return result;
+	}
+#endif
+}
+
+MemoryTag MemoryTracker::getCurrentTag()
+{
+	return currentTag;
+}
+
+MemoryTag MemoryTracker::setCurrentTag(MemoryTag tag)
+{
+	const auto prev = currentTag;
+	currentTag = tag;
+	return prev;
+}
+
+const char* MemoryTracker::getTagName(MemoryTag tag)
+{
+	switch (tag) {
+	case MemoryTag::Untagged:
+		return "untagged";
+	case MemoryTag::World:
+		return "world";
+	case MemoryTag::Resources:
+		return "resources";
+	case MemoryTag::Graphics:
+		return "graphics";
+	case MemoryTag::Audio:
+		return "audio";
+	case MemoryTag::UI:
+		return "ui";
+	case MemoryTag::Network:
+		return "network";
+	default:
+		return "unknown";
+	}
+}
+
+MemoryTagStats MemoryTracker::getStats(MemoryTag tag)
+{
+	const auto& c = counters[size_t(tag)];
+	MemoryTagStats result;
+	result.liveBytes = c.liveBytes.load(std::memory_order_relaxed);
+	result.liveAllocations = c.liveAllocations.load(std::memory_order_relaxed);
+	result.totalBytes = c.totalBytes.load(std::memory_order_relaxed);
+	result.totalAllocations = c.totalAllocations.load(std::memory_order_relaxed);
+	return result;
+}
+
+std::vector<MemoryCallSite> MemoryTracker::getTopCallSites(MemoryTag tag, size_t n)
+{
+	std::vector<MemoryCallSite> result;
+	result.reserve(CallSiteTable::capacity);
+	{
+		// Copy out first, as the vector allocates and would need this lock again
+		std::array<MemoryCallSite, CallSiteTable::capacity> entries;
+		{
+			std::unique_lock<std::mutex> lock(callSiteMutex);
+			entries = callSites[size_t(tag)].entries;
+		}
+		for (auto& e: entries) {
+			if (e.address) {
+				result.push_back(e);
+			}
+		}
+	}
+
+	std::sort(result.begin(), result.end(), [] (const MemoryCallSite& a, const MemoryCallSite& b) { return a.bytes > b.bytes; });
+	if (result.size() > n) {
+		result.resize(n);
+	}
+	return result;
+}
+
+void MemoryTracker::publishStats()
+{
+	if (!isEnabled()) {
+		return;
+	}
+
+	struct TagHandles
+	{
+		StatHandle liveBytes;
+		StatHandle allocations;
+		int64_t lastTotal = 0;
+	};
+	static std::array<TagHandles, numTags> handles;
+	static const Stats* registeredWith = nullptr;
+
+	const auto stats = Stats::getInstance();
+	if (registeredWith != stats) {
+		registeredWith = stats;
+		for (size_t i = 0; i < numTags; ++i) {
+			const String prefix = String("memory.") + getTagName(MemoryTag(i));
+			handles[i].liveBytes = Stats::get(prefix + ".liveBytes", StatKind::Value);
+			handles[i].allocations = Stats::get(prefix + ".allocations", StatKind::Value);
+		}
+	}
+
+	for (size_t i = 0; i < numTags; ++i) {
+		const auto s = getStats(MemoryTag(i));
+		auto& h = handles[i];
+		h.liveBytes.set(s.liveBytes);
+		h.allocations.set(s.totalAllocations - h.lastTotal);
+		h.lastTotal = s.totalAllocations;
+	}
+}
+
+String MemoryTracker::getReport(size_t callSitesPerTag)
+{
+	if (!isEnabled()) {
+		return "Memory tracking is disabled, build with HALLEY_TRACK_ALLOCATIONS to enable it.";
+	}
+
+	std::stringstream ss;
+	ss << "Memory by tag:";
+	for (size_t i = 0; i < numTags; ++i) {
+		const auto tag = MemoryTag(i);
+		const auto s = getStats(tag);
+		ss << "\n  " << getTagName(tag) << ": " << String::prettySize(s.liveBytes) << " live in " << s.liveAllocations << " allocations, "
+			<< String::prettySize(s.totalBytes) << " in " << s.totalAllocations << " allocations total";
+		for (auto& site: getTopCallSites(tag, callSitesPerTag)) {
+			ss << "\n    " << site.address << ": ~" << String::prettySize(site.bytes) << " in ~" << site.allocations << " allocations";
+		}
+	}
+	return ss.str();
+}
+
+#ifdef HALLEY_TRACK_ALLOCATIONS
+void* operator new(size_t size)
+{
+	return trackedAllocOrThrow(size, HALLEY_RETURN_ADDRESS());
+}
+
+void* operator new[](size_t size)
+{
+	return trackedAllocOrThrow(size, HALLEY_RETURN_ADDRESS());
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return trackedAlloc(size, HALLEY_RETURN_ADDRESS());
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return trackedAlloc(size, HALLEY_RETURN_ADDRESS());
+}
+
+void operator delete(void* ptr) noexcept
+{
+	trackedFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	trackedFree(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	trackedFree(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+	trackedFree(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+	trackedFree(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+	trackedFree(ptr);
+}
+#endif
@@ -26,7 +26,9 @@
 #include "os_ios.h"
 #include "os_linux.h"
 #include "halley/support/exception.h"
+#include "halley/support/logger.h"
 #include <fstream>
+#include <cstdio>
 
 using namespace Halley;
 
@@ -109,9 +111,27 @@ void OS::createDirectories(const Path& path)
 
 void OS::atomicWriteFile(const Path& path, const Bytes& data, Maybe<Path> backupOldVersionPath)
 {
-	std::ofstream fp(path.string(), std::ios::binary | std::ios::out);
-	fp.write(reinterpret_cast<const char*>(data.data()), data.size());
-	fp.close();
+	// Write everything to a temporary file first, so a crash mid-write never leaves a truncated file behind
+	const auto temp = path.replaceExtension(path.getExtension() + ".tmp");
+	{
+		std::ofstream fp(temp.string(), std::ios::binary | std::ios::out);
+		fp.write(reinterpret_cast<const char*>(data.data()), data.size());
+		fp.close();
+		if (fp.fail()) {
+			throw Exception("Unable to write file " + temp.getString(), HalleyExceptions::OS);
+		}
+	}
+
+	if (backupOldVersionPath) {
+		std::rename(path.string().c_str(), backupOldVersionPath.get().string().c_str());
+	}
+	if (std::rename(temp.string().c_str(), path.string().c_str()) != 0) {
+		Logger::logWarning("Unable to safely overwrite file " + path.getString());
+		std::ofstream fp(path.string(), std::ios::binary | std::ios::out);
+		fp.write(reinterpret_cast<const char*>(data.data()), data.size());
+		fp.close();
+		std::remove(temp.string().c_str());
+	}
 }
 
 std::vector<Path> OS::enumerateDirectory(const Path& path)
@@ -59,6 +59,12 @@ gsl::span<const gsl::byte> ResourceDataStatic::getSpan() const
 	return gsl::span<const gsl::byte>(reinterpret_cast<const gsl::byte*>(getData()), getSize());
 }
 
+std::shared_ptr<const char> ResourceDataStatic::getSharedData() const
+{
+	if (!loaded) throw Exception("Resource data not yet loaded", HalleyExceptions::Resources);
+	return data;
+}
+
 size_t ResourceDataStatic::getSize() const
 {
 	if (!loaded) throw Exception("Resource data not yet loaded", HalleyExceptions::Resources);
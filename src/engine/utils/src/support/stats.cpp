@@ -0,0 +1,241 @@
+#include "halley/support/stats.h"
+#include "halley/text/string_converter.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+
+using namespace Halley;
+
+Stats* Stats::instance = nullptr;
+
+Stats::Entry::Entry(String name, StatKind kind, size_t historyLength)
+	: name(std::move(name))
+	, kind(kind)
+	, current(0)
+	, history(historyLength)
+{
+}
+
+Stats::Stats(size_t historyLength)
+	: historyLength(std::max(historyLength, size_t(1)))
+{
+}
+
+void Stats::setInstance(Stats* stats)
+{
+	instance = stats;
+}
+
+Stats* Stats::getInstance()
+{
+	return instance;
+}
+
+StatHandle Stats::get(const String& name, StatKind kind)
+{
+	if (instance) {
+		return instance->getHandle(name, kind);
+	}
+	return StatHandle();
+}
+
+StatHandle Stats::getHandle(const String& name, StatKind kind)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	for (auto& e: entries) {
+		if (e->name == name) {
+			return StatHandle(e->current);
+		}
+	}
+	entries.push_back(std::make_unique<Entry>(name, kind, historyLength));
+	return StatHandle(entries.back()->current);
+}
+
+void Stats::sampleFrame()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	for (auto& e: entries) {
+		const int64_t value = e->kind == StatKind::Counter ? e->current.exchange(0, std::memory_order_relaxed) : e->current.load(std::memory_order_relaxed);
+		e->history.add(value);
+	}
+	++numFrames;
+}
+
+void Stats::clearHistory()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	for (auto& e: entries) {
+		e->history = CircularBuffer<int64_t>(historyLength);
+	}
+	numFrames = 0;
+}
+
+size_t Stats::getNumFrames() const
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	return std::min(numFrames, historyLength);
+}
+
+std::vector<String> Stats::getNames() const
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	std::vector<String> result;
+	result.reserve(entries.size());
+	for (auto& e: entries) {
+		result.push_back(e->name);
+	}
+	return result;
+}
+
+bool Stats::hasStat(const String& name) const
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	return tryGetEntry(name) != nullptr;
+}
+
+int64_t Stats::getLatest(const String& name) const
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	auto e = tryGetEntry(name);
+	return e && e->history.getSize() > 0 ? e->history[0] : 0;
+}
+
+int64_t Stats::getPercentile(const String& name, float percentile) const
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	auto e = tryGetEntry(name);
+	if (!e) {
+		return 0;
+	}
+
+	std::vector<int64_t> values(e->history.getSize());
+	for (size_t i = 0; i < values.size(); ++i) {
+		values[i] = e->history[i];
+	}
+	std::sort(values.begin(), values.end());
+	return getNearestRank(values, percentile);
+}
+
+StatSummary Stats::getSummary(const String& name) const
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	auto e = tryGetEntry(name);
+	if (!e) {
+		StatSummary result;
+		result.name = name;
+		result.kind = StatKind::Value;
+		return result;
+	}
+	return makeSummary(*e);
+}
+
+std::vector<StatSummary> Stats::getSummaries() const
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	std::vector<StatSummary> result;
+	result.reserve(entries.size());
+	for (auto& e: entries) {
+		result.push_back(makeSummary(*e));
+	}
+	return result;
+}
+
+String Stats::toCSV() const
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	std::stringstream ss;
+
+	ss << "frame";
+	for (auto& e: entries) {
+		ss << ',' << e->name;
+	}
+	ss << '\n';
+
+	// History is indexed by age, so walk it backwards to write the oldest frame first
+	const size_t nRows = std::min(numFrames, historyLength);
+	for (size_t row = 0; row < nRows; ++row) {
+		const size_t age = nRows - 1 - row;
+		ss << (numFrames - 1 - age);
+		for (auto& e: entries) {
+			ss << ',';
+			if (age < e->history.getSize()) {
+				ss << e->history[age];
+			}
+		}
+		ss << '\n';
+	}
+
+	return ss.str();
+}
+
+String Stats::toJSON() const
+{
+	auto summaries = getSummaries();
+	std::stringstream ss;
+
+	ss << "{\n";
+	for (size_t i = 0; i < summaries.size(); ++i) {
+		const auto& s = summaries[i];
+		ss << "\t\"" << s.name << "\": { "
+			<< "\"kind\": \"" << (s.kind == StatKind::Counter ? "counter" : "value") << "\", "
+			<< "\"latest\": " << s.latest << ", "
+			<< "\"average\": " << s.average << ", "
+			<< "\"max\": " << s.max << ", "
+			<< "\"p50\": " << s.p50 << ", "
+			<< "\"p95\": " << s.p95 << ", "
+			<< "\"p99\": " << s.p99 << " }"
+			<< (i + 1 < summaries.size() ? ",\n" : "\n");
+	}
+	ss << "}\n";
+
+	return ss.str();
+}
+
+const Stats::Entry* Stats::tryGetEntry(const String& name) const
+{
+	for (auto& e: entries) {
+		if (e->name == name) {
+			return e.get();
+		}
+	}
+	return nullptr;
+}
+
+StatSummary Stats::makeSummary(const Entry& entry) const
+{
+	StatSummary result;
+	result.name = entry.name;
+	result.kind = entry.kind;
+
+	const size_t n = entry.history.getSize();
+	if (n == 0) {
+		return result;
+	}
+
+	std::vector<int64_t> values(n);
+	int64_t total = 0;
+	for (size_t i = 0; i < n; ++i) {
+		values[i] = entry.history[i];
+		total += values[i];
+	}
+	result.latest = values[0];
+	result.average = total / int64_t(n);
+
+	std::sort(values.begin(), values.end());
+	result.max = values.back();
+	result.p50 = getNearestRank(values, 50);
+	result.p95 = getNearestRank(values, 95);
+	result.p99 = getNearestRank(values, 99);
+	return result;
+}
+
+int64_t Stats::getNearestRank(const std::vector<int64_t>& sortedValues, float percentile)
+{
+	if (sortedValues.empty()) {
+		return 0;
+	}
+
+	const float p = std::max(0.0f, std::min(percentile, 100.0f));
+	const size_t rank = size_t(std::ceil(p / 100.0f * float(sortedValues.size())));
+	return sortedValues[std::min(std::max(rank, size_t(1)), sortedValues.size()) - 1];
+}
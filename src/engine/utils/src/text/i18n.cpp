@@ -1,9 +1,88 @@
+#include <algorithm>
 #include <utility>
 #include "halley/text/i18n.h"
 #include "halley/file_formats/config_file.h"
+#include "halley/support/exception.h"
 
 using namespace Halley;
 
+I18NKey::I18NKey(const char* key)
+	: I18NKey(String(key))
+{
+}
+
+I18NKey::I18NKey(String key)
+	: key(std::move(key))
+	, hash(hashString(this->key))
+{
+}
+
+const String& I18NKey::getString() const
+{
+	return key;
+}
+
+uint64_t I18NKey::getHash() const
+{
+	return hash;
+}
+
+uint64_t I18NKey::hashString(const String& str, uint64_t seed)
+{
+	uint64_t hash = seed;
+	for (const char c: str.cppStr()) {
+		hash ^= uint64_t(uint8_t(c));
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+void I18N::Table::add(const String& key, const String& value)
+{
+	hashes.push_back(I18NKey::hashString(key));
+	entries.push_back(Entry{ std::make_shared<const String>(key), std::make_shared<const String>(value) });
+}
+
+void I18N::Table::compile()
+{
+	std::vector<std::pair<uint64_t, Entry>> sorted;
+	sorted.reserve(entries.size());
+	for (size_t i = 0; i < entries.size(); ++i) {
+		sorted.emplace_back(hashes[i], std::move(entries[i]));
+	}
+
+	// Stable, so that when a key is defined again the last definition wins
+	std::stable_sort(sorted.begin(), sorted.end(), [] (const std::pair<uint64_t, Entry>& a, const std::pair<uint64_t, Entry>& b) { return a.first < b.first; });
+
+	hashes.clear();
+	entries.clear();
+	for (auto& e: sorted) {
+		if (!hashes.empty() && hashes.back() == e.first) {
+			if (*entries.back().key != *e.second.key) {
+				throw Exception("Localisation keys \"" + *entries.back().key + "\" and \"" + *e.second.key + "\" have the same hash.", HalleyExceptions::Resources);
+			}
+			entries.back() = std::move(e.second);
+		} else {
+			hashes.push_back(e.first);
+			entries.push_back(std::move(e.second));
+		}
+	}
+}
+
+const I18N::Table::Entry* I18N::Table::find(uint64_t hash) const
+{
+	const auto iter = std::lower_bound(hashes.begin(), hashes.end(), hash);
+	if (iter != hashes.end() && *iter == hash) {
+		return &entries[iter - hashes.begin()];
+	}
+	return nullptr;
+}
+
+size_t I18N::Table::size() const
+{
+	return entries.size();
+}
+
 I18N::I18N()
 {
 }
@@ -21,12 +100,14 @@ void I18N::update()
 void I18N::setCurrentLanguage(const I18NLanguage& code)
 {
 	currentLanguage = code;
+	updateTables();
 	++version;
 }
 
 void I18N::setFallbackLanguage(const I18NLanguage& code)
 {
 	fallbackLanguage = code;
+	updateTables();
 }
 
 void I18N::loadLocalisationFile(const ConfigFile& config)
@@ -41,12 +122,28 @@ void I18N::loadLocalisation(const ConfigNode& root)
 		auto langCode = I18NLanguage(language.first);
 		auto& lang = strings[langCode];
 		for (auto& e: language.second.asMap()) {
-			lang[e.first] = e.second.asString();
+			lang.add(e.first, e.second.asString());
 		}
+		lang.compile();
 	}
+	updateTables();
 	++version;
 }
 
+void I18N::updateTables()
+{
+	const auto cur = strings.find(currentLanguage);
+	currentTable = cur != strings.end() ? &cur->second : nullptr;
+
+	fallbackTable = nullptr;
+	if (fallbackLanguage && fallbackLanguage.get() != currentLanguage) {
+		const auto fallback = strings.find(fallbackLanguage.get());
+		if (fallback != strings.end()) {
+			fallbackTable = &fallback->second;
+		}
+	}
+}
+
 std::vector<I18NLanguage> I18N::getLanguagesAvailable() const
 {
 	std::vector<I18NLanguage> result;
@@ -58,25 +155,36 @@ std::vector<I18NLanguage> I18N::getLanguagesAvailable() const
 
 LocalisedString I18N::get(const String& key) const
 {
-	auto curLang = strings.find(currentLanguage);
-	if (curLang != strings.end()) {
-		auto i = curLang->second.find(key);
-		if (i != curLang->second.end()) {
-			return LocalisedString(*this, key, i->second);
-		}
-	}
+	return get(I18NKey::hashString(key), &key);
+}
 
-	if (fallbackLanguage && fallbackLanguage.get() != currentLanguage) {
-		auto defLang = strings.find(fallbackLanguage.get());
-		if (defLang != strings.end()) {
-			auto i = defLang->second.find(key);
-			if (i != defLang->second.end()) {
-				return LocalisedString(*this, key, i->second);
+LocalisedString I18N::get(const I18NKey& key) const
+{
+	return get(key.getHash(), &key.getString());
+}
+
+LocalisedString I18N::get(uint64_t hash, const String* key) const
+{
+	for (const auto* table: { currentTable, fallbackTable }) {
+		if (table) {
+			if (const auto* entry = table->find(hash)) {
+				return LocalisedString(*this, hash, entry->key, entry->value);
 			}
 		}
 	}
 
-	return LocalisedString(*this, key, "#MISSING#");
+	static const auto missing = std::make_shared<const String>("#MISSING#");
+	return LocalisedString(*this, hash, key ? std::make_shared<const String>(*key) : std::shared_ptr<const String>(), missing);
+}
+
+LocalisedString I18N::getWithPrefix(uint64_t prefixHash, const String& prefix, const String& key) const
+{
+	auto result = get(I18NKey::hashString(key, prefixHash), nullptr);
+	if (!result.key) {
+		// Only build the full key when it's missing, for reporting
+		result.key = std::make_shared<const String>(prefix + key);
+	}
+	return result;
 }
 
 LocalisedString I18N::getPreProcessedUserString(const String& string) const
@@ -113,17 +221,18 @@ LocalisedString::LocalisedString()
 
 LocalisedString& LocalisedString::operator+=(const LocalisedString& str)
 {
-	string += str.string;
+	string = std::make_shared<const String>(getString() + str.getString());
 	return *this;
 }
 
 LocalisedString::LocalisedString(String string)
-	: string(std::move(string))
+	: string(std::make_shared<const String>(std::move(string)))
 {
 }
 
-LocalisedString::LocalisedString(const I18N& i18n, String key, String string)
+LocalisedString::LocalisedString(const I18N& i18n, uint64_t keyHash, std::shared_ptr<const String> key, std::shared_ptr<const String> string)
 	: i18n(&i18n)
+	, keyHash(keyHash)
 	, key(std::move(key))
 	, string(std::move(string))
 	, i18nVersion(i18n.getVersion())
@@ -237,37 +346,38 @@ LocalisedString LocalisedString::fromNumber(int number)
 
 LocalisedString LocalisedString::replaceTokens(const LocalisedString& tok0) const
 {
-	return LocalisedString(string.replaceAll("{0}", tok0.getString()));
+	return LocalisedString(getString().replaceAll("{0}", tok0.getString()));
 }
 
 LocalisedString LocalisedString::replaceTokens(const LocalisedString& tok0, const LocalisedString& tok1) const
 {
-	return LocalisedString(string.replaceAll("{0}", tok0.getString()).replaceAll("{1}", tok1.getString()));
+	return LocalisedString(getString().replaceAll("{0}", tok0.getString()).replaceAll("{1}", tok1.getString()));
 }
 
 LocalisedString LocalisedString::replaceTokens(const LocalisedString& tok0, const LocalisedString& tok1, const LocalisedString& tok2) const
 {
-	return LocalisedString(string.replaceAll("{0}", tok0.getString()).replaceAll("{1}", tok1.getString()).replaceAll("{2}", tok2.getString()));
+	return LocalisedString(getString().replaceAll("{0}", tok0.getString()).replaceAll("{1}", tok1.getString()).replaceAll("{2}", tok2.getString()));
 }
 
 const String& LocalisedString::getString() const
 {
-	return string;
+	static const String empty;
+	return string ? *string : empty;
 }
 
 bool LocalisedString::operator==(const LocalisedString& other) const
 {
-	return string == other.string;
+	return string == other.string || getString() == other.getString();
 }
 
 bool LocalisedString::operator!=(const LocalisedString& other) const
 {
-	return string != other.string;
+	return !(*this == other);
 }
 
 bool LocalisedString::operator<(const LocalisedString& other) const
 {
-	return string < other.string;
+	return getString() < other.getString();
 }
 
 bool LocalisedString::checkForUpdates()
@@ -275,11 +385,12 @@ bool LocalisedString::checkForUpdates()
 	if (i18n) {
 		const auto curVersion = i18n->getVersion();
 		if (i18nVersion != curVersion) {
-			const auto newValue = i18n->get(key);
+			auto newValue = i18n->get(keyHash, key.get());
 			i18nVersion = curVersion;
 			if (string != newValue.string) {
-				string = newValue.string;
-				return true;
+				const bool changed = getString() != newValue.getString();
+				string = std::move(newValue.string);
+				return changed;
 			}
 		}
 	}
@@ -6,6 +6,17 @@
 #include "halley/support/logger.h"
 #include "halley/text/encode.h"
 
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define HAS_AESNI
+#include <wmmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define AESNI_TARGET
+#else
+#define AESNI_TARGET __attribute__((target("aes,sse2")))
+#endif
+#endif
+
 using namespace Halley;
 
 Bytes Encrypt::encrypt(const Bytes& iv, const String& key, const Bytes& data)
@@ -65,3 +76,159 @@ Bytes Encrypt::decrypt(const Bytes& iv, const String& key, const Bytes& data)
 
 	return result;
 }
+
+
+namespace {
+	// Counter block is the IV plus the block index, as a 128-bit big endian number
+	class CTRCounter {
+	public:
+		explicit CTRCounter(const std::array<uint8_t, 16>& iv)
+			: hi(readBigEndian(iv.data()))
+			, lo(readBigEndian(iv.data() + 8))
+		{}
+
+		void get(uint64_t block, uint8_t* dst) const
+		{
+			const uint64_t l = lo + block;
+			const uint64_t h = hi + (l < lo ? 1 : 0);
+			writeBigEndian(h, dst);
+			writeBigEndian(l, dst + 8);
+		}
+
+	private:
+		uint64_t hi;
+		uint64_t lo;
+
+		static uint64_t readBigEndian(const uint8_t* src)
+		{
+			uint64_t v = 0;
+			for (int i = 0; i < 8; ++i) {
+				v = (v << 8) | src[i];
+			}
+			return v;
+		}
+
+		static void writeBigEndian(uint64_t v, uint8_t* dst)
+		{
+			for (int i = 7; i >= 0; --i) {
+				dst[i] = static_cast<uint8_t>(v);
+				v >>= 8;
+			}
+		}
+	};
+
+	void xorBytes(uint8_t* dst, const uint8_t* keystream, size_t n)
+	{
+		for (size_t i = 0; i < n; ++i) {
+			dst[i] ^= keystream[i];
+		}
+	}
+
+#ifdef HAS_AESNI
+	bool hasAESNI()
+	{
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 1);
+		return (info[2] & (1 << 25)) != 0;
+#else
+		return __builtin_cpu_supports("aes") != 0;
+#endif
+	}
+
+	AESNI_TARGET void applyCTRAESNI(const uint8_t* roundKeyBytes, const std::array<uint8_t, 16>& iv, uint64_t block, size_t skip, uint8_t* data, size_t size)
+	{
+		__m128i roundKeys[11];
+		for (int i = 0; i < 11; ++i) {
+			roundKeys[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(roundKeyBytes + 16 * i));
+		}
+
+		const CTRCounter counter(iv);
+		alignas(16) uint8_t counters[64];
+		while (size > 0) {
+			// Four blocks at a time, so the AES units stay busy
+			const size_t nBlocks = std::min(size_t(4), (skip + size + 15) / 16);
+			__m128i ks[4];
+			for (size_t i = 0; i < nBlocks; ++i) {
+				counter.get(block + i, counters + 16 * i);
+				ks[i] = _mm_xor_si128(_mm_load_si128(reinterpret_cast<const __m128i*>(counters + 16 * i)), roundKeys[0]);
+			}
+			for (int r = 1; r < 10; ++r) {
+				for (size_t i = 0; i < nBlocks; ++i) {
+					ks[i] = _mm_aesenc_si128(ks[i], roundKeys[r]);
+				}
+			}
+			for (size_t i = 0; i < nBlocks; ++i) {
+				ks[i] = _mm_aesenclast_si128(ks[i], roundKeys[10]);
+			}
+
+			if (nBlocks == 4 && skip == 0 && size >= 64) {
+				for (size_t i = 0; i < 4; ++i) {
+					auto* p = reinterpret_cast<__m128i*>(data + 16 * i);
+					_mm_storeu_si128(p, _mm_xor_si128(_mm_loadu_si128(p), ks[i]));
+				}
+				data += 64;
+				size -= 64;
+				block += 4;
+				continue;
+			}
+
+			for (size_t i = 0; i < nBlocks; ++i) {
+				_mm_store_si128(reinterpret_cast<__m128i*>(counters + 16 * i), ks[i]);
+			}
+			const size_t n = std::min(nBlocks * 16 - skip, size);
+			xorBytes(data, counters + skip, n);
+			data += n;
+			size -= n;
+			block += nBlocks;
+			skip = 0;
+		}
+	}
+#endif
+}
+
+Encrypt::CTRCipher::CTRCipher(const Bytes& iv, const String& key)
+	: ctx(std::make_unique<AES_ctx>())
+{
+	Expects(iv.size() == 16);
+	Expects(key.size() >= 16);
+
+	memcpy(this->iv.data(), iv.data(), 16);
+	std::memset(ctx.get(), 0, sizeof(AES_ctx));
+	AES_init_ctx(ctx.get(), reinterpret_cast<const uint8_t*>(key.c_str()));
+
+#ifdef HAS_AESNI
+	useAESNI = hasAESNI();
+#endif
+}
+
+Encrypt::CTRCipher::~CTRCipher() = default;
+
+void Encrypt::CTRCipher::apply(size_t offset, gsl::span<gsl::byte> data) const
+{
+	auto* dst = reinterpret_cast<uint8_t*>(data.data());
+	size_t size = size_t(data.size());
+	uint64_t block = offset / AES_BLOCKLEN;
+	size_t skip = offset % AES_BLOCKLEN;
+
+#ifdef HAS_AESNI
+	if (useAESNI) {
+		applyCTRAESNI(ctx->RoundKey, iv, block, skip, dst, size);
+		return;
+	}
+#endif
+
+	const CTRCounter counter(iv);
+	uint8_t keystream[AES_BLOCKLEN];
+	while (size > 0) {
+		counter.get(block, keystream);
+		AES_ECB_encrypt(ctx.get(), keystream);
+
+		const size_t n = std::min(AES_BLOCKLEN - skip, size);
+		xorBytes(dst, keystream + skip, n);
+		dst += n;
+		size -= n;
+		++block;
+		skip = 0;
+	}
+}
@@ -48,7 +48,7 @@ void MFMoviePlayer::init()
 
 	std::array<wchar_t, 256> tmpPath;
 	GetTempPathW(DWORD(tmpPath.size()), tmpPath.data());
-	tempFileName = String(tmpPath.data()) + "\\hlyvid" + toString(int(Random::getGlobal().getRawInt())) + ".mp4";
+	tempFileName = String(tmpPath.data()) + "\\hlyvid" + toString(int(Random::getThreadLocal().getRawInt())) + ".mp4";
 	auto tmpFile = CreateFileW(tempFileName.getUTF16().c_str(), GENERIC_WRITE, FILE_SHARE_WRITE, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY, nullptr);
 	auto fullData = data->getReader()->readAll();
 	DWORD remaining = DWORD(fullData.size());
@@ -286,6 +286,12 @@ void MFMoviePlayer::requestAudioFrame()
 	onReadSample(hr, streamIndex, streamFlags, timestamp, sample);
 }
 
+bool MFMoviePlayer::shouldRecycleTextures() const
+{
+	// All our frames go through onVideoFrameAvailable(Time, TextureDescriptor&&), so the textures are ours to reuse
+	return true;
+}
+
 void MFMoviePlayer::onReset()
 {
 	PROPVARIANT pos;
@@ -377,7 +383,7 @@ void MFMoviePlayer::readVideoSample(Time time, const gsl::byte* data, int stride
 	const int height = yPlaneHeight + uvPlaneHeight;
 
 	auto srcData = gsl::span<const gsl::byte>(data, stride * height);
-	Bytes myData(srcData.size_bytes());
+	Bytes myData = getFrameBuffer(size_t(srcData.size_bytes()));
 	memcpy(myData.data(), data, myData.size());
 
 	TextureDescriptor descriptor;
@@ -392,11 +398,5 @@ void MFMoviePlayer::readVideoSample(Time time, const gsl::byte* data, int stride
 void MFMoviePlayer::readAudioSample(Time time, gsl::span<const gsl::byte> data)
 {
 	auto src = gsl::span<const short>(reinterpret_cast<const short*>(data.data()), data.size() / sizeof(short));
-
-	std::vector<AudioConfig::SampleFormat> samples(src.size());
-	for (int i = 0; i < src.size(); ++i) {
-		samples[i] = src[i] / 32768.0f;
-	}
-
-	onAudioFrameAvailable(time, samples);
+	onAudioFrameAvailable(time, src);
 }
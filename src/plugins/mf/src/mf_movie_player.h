@@ -29,6 +29,7 @@ namespace Halley
 		void requestVideoFrame() override;
 		void requestAudioFrame() override;
 		void onReset() override;
+		bool shouldRecycleTextures() const override;
 
 	private:
 		std::shared_ptr<ResourceDataStream> data;
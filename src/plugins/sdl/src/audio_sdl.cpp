@@ -21,6 +21,7 @@ void AudioSDL::init()
 	if (SDL_InitSubSystem(SDL_INIT_AUDIO) == -1) {
 		throw Exception(String("Exception initializing audio: ") + SDL_GetError(), HalleyExceptions::AudioOutPlugin);
 	}
+	underrunsStat = Stats::get("audio.underruns");
 }
 
 bool AudioSDL::needsAudioThread() const
@@ -207,6 +208,7 @@ void AudioSDL::onCallback(unsigned char* stream, int len)
 	if (remaining > 0) {
 		// :(
 		Logger::logWarning("Insufficient audio data, padding with zeroes.");
+		underrunsStat.add();
 		memset(stream + pos, 0, remaining);
 	}
 }
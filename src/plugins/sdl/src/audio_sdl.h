@@ -1,5 +1,6 @@
 #pragma once
 #include "halley/core/api/halley_api_internal.h"
+#include "halley/support/stats.h"
 #include "input_sdl.h"
 #include <cstdint>
 #include <vector>
@@ -49,6 +50,7 @@ namespace Halley
 		size_t queuedSize = 0;
 
 		AudioCallback prepareAudioCallback;
+		StatHandle underrunsStat;
 
 		void doQueueAudio(gsl::span<const gsl::byte> data);
 	};
@@ -149,6 +149,7 @@ int InputJoystickSDL::getSDLAxisIndex(int axis)
 void InputJoystickSDL::processAxisEvent(int axis, float value)
 {
 	axes[axis] = value;
+	notifyStateChanged();
 
 	if (axis == SDL_CONTROLLER_AXIS_TRIGGERLEFT) {
 		onButtonStatus(getButtonAtPosition(JoystickButtonPosition::TriggerLeft), value > 0.5f);
@@ -4,6 +4,7 @@
 #include "halley/maths/random.h"
 #include "halley/utils/encrypt.h"
 #include "halley/utils/hash.h"
+#include "halley/concurrency/concurrent.h"
 using namespace Halley;
 
 SDLSaveHeaderV0::SDLSaveHeaderV0()
@@ -78,7 +79,8 @@ bool SDLSaveHeader::isValid(const String& path, const String& key) const
 
 void SDLSaveHeader::generateIV()
 {
-	Random::getGlobal().getBytes(gsl::as_writeable_bytes(gsl::span<char>(v0.iv.data(), v0.iv.size())));
+	// Saves are written from the disk IO thread
+	Random::getThreadLocal().getBytes(gsl::as_writeable_bytes(gsl::span<char>(v0.iv.data(), v0.iv.size())));
 }
 
 Bytes SDLSaveHeader::getIV() const
@@ -103,6 +105,11 @@ SDLSaveData::SDLSaveData(SaveDataType type, Path dir, Maybe<String> key)
 	OS::get().createDirectories(this->dir);
 }
 
+SDLSaveData::~SDLSaveData()
+{
+	waitForPendingWrites();
+}
+
 bool SDLSaveData::isReady() const
 {
 	return true;
@@ -112,6 +119,15 @@ Bytes SDLSaveData::getData(const String& filename)
 {
 	Expects (!filename.isEmpty());
 
+	{
+		// Data that hasn't been written yet is the most recent version
+		std::unique_lock<std::mutex> lock(mutex);
+		const auto iter = pendingWrites.find(filename);
+		if (iter != pendingWrites.end()) {
+			return *iter->second.data;
+		}
+	}
+
 	auto path = dir / filename;
 	Maybe<Bytes> data = doGetData(path, filename);
 	if (data) {
@@ -130,6 +146,21 @@ Bytes SDLSaveData::getData(const String& filename)
 void SDLSaveData::removeData(const String& path)
 {
 	Expects (!path.isEmpty());
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		const auto iter = pendingWrites.find(path);
+		if (iter != pendingWrites.end()) {
+			for (auto& p: iter->second.promises) {
+				p.setValue(false);
+			}
+			pendingWrites.erase(iter);
+		}
+
+		// Don't let a write that's already in flight recreate the file
+		writeFinished.wait(lock, [&] () { return !writerActive; });
+	}
+	
 	return Path::removeFile(dir / path);
 }
 
@@ -143,6 +174,13 @@ std::vector<String> SDLSaveData::enumerate(const String& root)
 			result.push_back(path);
 		}
 	}
+
+	std::unique_lock<std::mutex> lock(mutex);
+	for (auto& p: pendingWrites) {
+		if (p.first.startsWith(root) && std::find(result.begin(), result.end(), p.first) == result.end()) {
+			result.push_back(p.first);
+		}
+	}
 	return result;
 }
 
@@ -150,6 +188,124 @@ void SDLSaveData::setData(const String& path, const Bytes& rawData, bool commit)
 {
 	Expects (!path.isEmpty());
 
+	queueWrite(path, std::make_shared<const Bytes>(rawData));
+	if (commit) {
+		this->commit();
+	}
+}
+
+Future<bool> SDLSaveData::setDataAsync(const String& path, Bytes data)
+{
+	Expects (!path.isEmpty());
+
+	auto future = queueWrite(path, std::make_shared<const Bytes>(std::move(data)));
+	std::unique_lock<std::mutex> lock(mutex);
+	startWriting(lock);
+	return future;
+}
+
+void SDLSaveData::commit()
+{
+	// Synchronous: everything queued so far is on disk when this returns
+	waitForPendingWrites();
+}
+
+void SDLSaveData::waitForPendingWrites()
+{
+	// Write on this thread rather than waiting for the disk IO thread to get to it, as it may be busy or not running at all.
+	// Only a write that's already in progress elsewhere is waited for, and that one will pick up everything still queued.
+	std::unique_lock<std::mutex> lock(mutex);
+	writeFinished.wait(lock, [&] () { return !writerActive; });
+	processWrites(lock);
+}
+
+Future<bool> SDLSaveData::queueWrite(const String& path, std::shared_ptr<const Bytes> data)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	// Repeated writes to the same path replace the pending data, so only the latest one hits the disk
+	auto& write = pendingWrites[path];
+	write.data = std::move(data);
+	write.generation = nextGeneration++;
+	write.promises.emplace_back();
+	return write.promises.back().getFuture();
+}
+
+static bool hasDiskIOThread()
+{
+	return Executors::hasInstance() && Executors::getDiskIO().threadCount() > 0;
+}
+
+void SDLSaveData::startWriting(std::unique_lock<std::mutex>& lock)
+{
+	if (writeQueued || writerActive || pendingWrites.empty()) {
+		return;
+	}
+
+	if (!hasDiskIOThread()) {
+		processWrites(lock);
+		return;
+	}
+
+	// Only hold a weak reference, so a task that runs after we're gone does nothing
+	writeQueued = true;
+	std::weak_ptr<SDLSaveData> weakThis = shared_from_this();
+	Concurrent::execute(Executors::getDiskIO(), [weakThis] ()
+	{
+		if (auto self = weakThis.lock()) {
+			std::unique_lock<std::mutex> selfLock(self->mutex);
+			self->writeQueued = false;
+			self->processWrites(selfLock);
+		}
+	});
+}
+
+void SDLSaveData::processWrites(std::unique_lock<std::mutex>& lock)
+{
+	// Must be called with mutex held through lock. Only one thread writes at a time; it keeps going until the queue is empty.
+	if (writerActive) {
+		return;
+	}
+	writerActive = true;
+
+	while (!pendingWrites.empty()) {
+		auto& write = *pendingWrites.begin();
+		const String path = write.first;
+		const std::shared_ptr<const Bytes> data = write.second.data;
+		const uint64_t generation = write.second.generation;
+		std::vector<Promise<bool>> promises = std::move(write.second.promises);
+		write.second.promises.clear();
+		lock.unlock();
+
+		bool ok = true;
+		try {
+			doSetData(path, *data);
+		} catch (std::exception& e) {
+			Logger::logException(e);
+			ok = false;
+		} catch (...) {
+			Logger::logError("Unknown error saving \"" + path + "\"");
+			ok = false;
+		}
+
+		for (auto& p: promises) {
+			p.setValue(bool(ok));
+		}
+
+		// Keep the entry if it was replaced while we were writing it
+		lock.lock();
+		const auto iter = pendingWrites.find(path);
+		if (iter != pendingWrites.end() && iter->second.generation == generation) {
+			pendingWrites.erase(iter);
+		}
+	}
+
+	writerActive = false;
+	writeFinished.notify_all();
+}
+
+void SDLSaveData::doSetData(const String& path, const Bytes& rawData)
+{
 	Bytes finalData;
 	const bool encrypted = static_cast<bool>(key);
 
@@ -174,6 +330,7 @@ void SDLSaveData::setData(const String& path, const Bytes& rawData, bool commit)
 	auto dstPath = dir / path;
 	auto dstPathStr = dstPath.getString();
 	Maybe<Path> backupPath;
+	std::unique_lock<std::mutex> lock(mutex);
 	if (corruptedFiles.find(dstPathStr) != corruptedFiles.end()) {
 		// File we're writing to was corrupted; don't back up, but do remove it from the list
 		corruptedFiles.erase(dstPathStr);
@@ -184,6 +341,7 @@ void SDLSaveData::setData(const String& path, const Bytes& rawData, bool commit)
 			backupPath = dstPath.replaceExtension(dstPath.getExtension() + ".bak");
 		}
 	}
+	lock.unlock();
 
 	// Write
 	OS::get().createDirectories(dir);
@@ -191,10 +349,6 @@ void SDLSaveData::setData(const String& path, const Bytes& rawData, bool commit)
 	Logger::logDev("Saving \"" + path + "\", " + String::prettySize(finalData.size()));
 }
 
-void SDLSaveData::commit()
-{
-}
-
 String SDLSaveData::getKey() const
 {
 	if (key) {
@@ -237,9 +391,10 @@ Maybe<Bytes> SDLSaveData::doGetData(const Path& path, const String& filename)
 	if (header.v0.version >= 1 && header.v1.dataHash != Hash::hash(finalData)) {
 		Logger::logError("Corrupted save file: " + filename);
 		if (!path.getExtension().endsWith(".bak")) {
+			std::unique_lock<std::mutex> lock(mutex);
 			corruptedFiles.insert(path.getString());
 		}
-;		return {};
+		return {};
 	}
 	return finalData;
 }
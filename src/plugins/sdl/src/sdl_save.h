@@ -2,6 +2,9 @@
 
 #include "halley/core/api/halley_api_internal.h"
 #include <set>
+#include <map>
+#include <mutex>
+#include <condition_variable>
 
 namespace Halley {
 	struct SDLSaveHeaderV0
@@ -34,23 +37,45 @@ namespace Halley {
 		static uint64_t computeHash(const String& path, const String& key);
 	};
 
-	class SDLSaveData : public ISaveData {
+	class SDLSaveData : public ISaveData, public std::enable_shared_from_this<SDLSaveData> {
 	public:
 		explicit SDLSaveData(SaveDataType type, Path dir, Maybe<String> key);
+		~SDLSaveData();
 		bool isReady() const override;
 		Bytes getData(const String& path) override;
 		void removeData(const String& path) override;
 		std::vector<String> enumerate(const String& root) override;
 		void setData(const String& path, const Bytes& data, bool commit) override;
 		void commit() override;
+		Future<bool> setDataAsync(const String& path, Bytes data) override;
+		void waitForPendingWrites() override;
 
 	private:
+		struct PendingWrite {
+			std::shared_ptr<const Bytes> data;
+			uint64_t generation = 0;
+			std::vector<Promise<bool>> promises;
+		};
+
 		SaveDataType type;
 		Path dir;
 		Maybe<String> key;
+
+		// Guards everything below, which is shared with the disk IO thread
+		std::mutex mutex;
+		std::condition_variable writeFinished;
 		std::set<String> corruptedFiles;
+		std::map<String, PendingWrite> pendingWrites;
+		uint64_t nextGeneration = 0;
+		bool writeQueued = false; // A task is waiting on the disk IO queue
+		bool writerActive = false; // Some thread is inside processWrites
 
 		String getKey() const;
 		Maybe<Bytes> doGetData(const Path& path, const String& filename);
+		void doSetData(const String& path, const Bytes& rawData);
+
+		Future<bool> queueWrite(const String& path, std::shared_ptr<const Bytes> data);
+		void startWriting(std::unique_lock<std::mutex>& lock);
+		void processWrites(std::unique_lock<std::mutex>& lock);
 	};
 }
@@ -0,0 +1,62 @@
+#pragma once
+#include <functional>
+#include <cstdint>
+#include "halley/text/halleystring.h"
+#include "halley/data_structures/vector.h"
+#include "halley/time/halleytime.h"
+
+namespace Halley
+{
+	struct BenchmarkResult
+	{
+		String name;
+		size_t iterations = 0; // Per repetition
+		int repetitions = 0;
+		double nsPerIteration = 0; // Median of all repetitions
+		double minNs = 0;
+		double maxNs = 0;
+		double bytesPerSecond = 0; // Zero unless the benchmark declared how many bytes each iteration processes
+		size_t outputBytes = 0; // Zero unless the body reported the size of what it produced
+	};
+
+	// Minimal headless micro-benchmark harness.
+	// Each benchmark is a setup function that runs untimed and returns the body to be measured. The body is
+	// called in a loop, the iteration count is doubled until a batch takes at least minTime, and then the batch
+	// is repeated to get a median that is stable enough to compare between commits.
+	class BenchmarkRunner
+	{
+	public:
+		using Body = std::function<void()>;
+		using Setup = std::function<Body()>;
+
+		explicit BenchmarkRunner(Time minTime = 0.1, int repetitions = 5);
+
+		void add(String name, Setup setup, size_t bytesPerIteration = 0);
+		Vector<BenchmarkResult> run(const String& filter, std::function<void(const BenchmarkResult&)> onResult = {}) const;
+
+		// Feeds a value into a volatile sink, so the work that produced it can't be optimised away
+		static void consume(uint64_t value);
+
+		// Records the size of the body's output (e.g. encoded or compressed size), reported next to the timing
+		static void reportOutputBytes(size_t bytes);
+
+		static String toJSON(const Vector<BenchmarkResult>& results);
+		static String toCSV(const Vector<BenchmarkResult>& results);
+		static String toText(const BenchmarkResult& result);
+
+	private:
+		struct Entry
+		{
+			String name;
+			Setup setup;
+			size_t bytesPerIteration;
+		};
+
+		Time minTime;
+		int repetitions;
+		Vector<Entry> entries;
+
+		BenchmarkResult runOne(const Entry& entry) const;
+		static int64_t timeBatch(const Body& body, size_t iterations);
+	};
+}
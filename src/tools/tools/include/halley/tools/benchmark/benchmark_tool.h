@@ -0,0 +1,15 @@
+#pragma once
+#include "halley/tools/cli_tool.h"
+
+namespace Halley
+{
+	class BenchmarkRunner;
+
+	class BenchmarkTool : public CommandLineTool
+	{
+	public:
+		int run(Vector<std::string> args) override;
+
+		static void addEngineBenchmarks(BenchmarkRunner& runner);
+	};
+}
@@ -5,6 +5,7 @@
 #include "halley/core/resources/asset_database.h"
 #include "halley/data_structures/maybe.h"
 #include <set>
+#include <map>
 
 namespace Halley {
 	class Project;
@@ -31,7 +32,7 @@ namespace Halley {
 		
 		void setActive(bool active);
 		bool isActive() const;
-		void sort();
+		void sort(const std::map<String, size_t>& accessOrder);
 
 	private:
 		String name;
@@ -48,7 +49,8 @@ namespace Halley {
 		static void packPlatform(Project& project, Maybe<std::set<String>> assetsToPack, const std::vector<String>& deletedAssets, const String& platform);
 
 	private:
-		static std::map<String, AssetPackListing> sortIntoPacks(const AssetPackManifest& manifest, const AssetDatabase& srcAssetDb, Maybe<std::set<String>> assetsToPack, const std::vector<String>& deletedAssets);
+		static std::map<String, AssetPackListing> sortIntoPacks(const AssetPackManifest& manifest, const AssetDatabase& srcAssetDb, const std::map<String, size_t>& accessOrder, Maybe<std::set<String>> assetsToPack, const std::vector<String>& deletedAssets);
+		static std::map<String, size_t> getAccessOrder(const AssetDatabase& srcAssetDb, const Path& src);
 		static void generatePacks(std::map<String, AssetPackListing> packs, const Path& src, const Path& dst);
 		static void generatePack(const String& packId, const AssetPackListing& pack, const Path& src, const Path& dst);
 	};
@@ -17,5 +17,6 @@ void TextureImporter::import(const ImportingAsset& asset, IAssetCollector& colle
 	s >> image;
 
 	// Encode to PNG and save
-	collector.output(asset.assetId, AssetType::Texture, image.savePNGToBytes(), meta);
+	const auto encoding = fromString<Image::PNGEncoding>(meta.getString("pngEncoding", "small"));
+	collector.output(asset.assetId, AssetType::Texture, image.savePNGToBytes(true, encoding), meta);
 }
@@ -0,0 +1,142 @@
+#include "halley/tools/benchmark/benchmark_runner.h"
+#include "halley/time/stopwatch.h"
+#include "halley/text/string_converter.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+using namespace Halley;
+
+namespace {
+	volatile uint64_t benchmarkSink = 0;
+	size_t benchmarkOutputBytes = 0;
+}
+
+BenchmarkRunner::BenchmarkRunner(Time minTime, int repetitions)
+	: minTime(minTime)
+	, repetitions(std::max(repetitions, 1))
+{
+}
+
+void BenchmarkRunner::add(String name, Setup setup, size_t bytesPerIteration)
+{
+	entries.push_back(Entry{ std::move(name), std::move(setup), bytesPerIteration });
+}
+
+Vector<BenchmarkResult> BenchmarkRunner::run(const String& filter, std::function<void(const BenchmarkResult&)> onResult) const
+{
+	Vector<BenchmarkResult> results;
+	for (auto& e: entries) {
+		if (filter.isEmpty() || filter == "all" || e.name.contains(filter)) {
+			results.push_back(runOne(e));
+			if (onResult) {
+				onResult(results.back());
+			}
+		}
+	}
+	return results;
+}
+
+void BenchmarkRunner::consume(uint64_t value)
+{
+	benchmarkSink = benchmarkSink + value;
+}
+
+void BenchmarkRunner::reportOutputBytes(size_t bytes)
+{
+	benchmarkOutputBytes = bytes;
+}
+
+BenchmarkResult BenchmarkRunner::runOne(const Entry& entry) const
+{
+	benchmarkOutputBytes = 0;
+	const auto body = entry.setup();
+	const auto minNs = int64_t(minTime * 1000000000.0);
+
+	// Warm up caches and find a batch size that takes long enough to time reliably
+	size_t iterations = 1;
+	int64_t elapsed = timeBatch(body, iterations);
+	while (elapsed < minNs) {
+		const size_t predicted = elapsed > 0 ? size_t(double(iterations) * double(minNs) / double(elapsed) * 1.2) : iterations * 10;
+		iterations = std::max(iterations * 2, std::min(predicted, iterations * 100));
+		elapsed = timeBatch(body, iterations);
+	}
+
+	std::vector<double> samples;
+	samples.reserve(repetitions);
+	for (int i = 0; i < repetitions; ++i) {
+		samples.push_back(double(timeBatch(body, iterations)) / double(iterations));
+	}
+	std::sort(samples.begin(), samples.end());
+
+	BenchmarkResult result;
+	result.name = entry.name;
+	result.iterations = iterations;
+	result.repetitions = repetitions;
+	result.nsPerIteration = samples[samples.size() / 2];
+	result.minNs = samples.front();
+	result.maxNs = samples.back();
+	if (entry.bytesPerIteration > 0 && result.nsPerIteration > 0) {
+		result.bytesPerSecond = double(entry.bytesPerIteration) * 1000000000.0 / result.nsPerIteration;
+	}
+	result.outputBytes = benchmarkOutputBytes;
+	return result;
+}
+
+int64_t BenchmarkRunner::timeBatch(const Body& body, size_t iterations)
+{
+	Stopwatch timer;
+	for (size_t i = 0; i < iterations; ++i) {
+		body();
+	}
+	timer.pause();
+	return timer.elapsedNanoSeconds();
+}
+
+String BenchmarkRunner::toJSON(const Vector<BenchmarkResult>& results)
+{
+	std::stringstream ss;
+	ss << std::fixed << std::setprecision(2);
+	ss << "{\n\t\"benchmarks\": [\n";
+	for (size_t i = 0; i < results.size(); ++i) {
+		const auto& r = results[i];
+		ss << "\t\t{ "
+			<< "\"name\": \"" << r.name << "\", "
+			<< "\"iterations\": " << r.iterations << ", "
+			<< "\"repetitions\": " << r.repetitions << ", "
+			<< "\"ns_per_iteration\": " << r.nsPerIteration << ", "
+			<< "\"min_ns\": " << r.minNs << ", "
+			<< "\"max_ns\": " << r.maxNs << ", "
+			<< "\"bytes_per_second\": " << r.bytesPerSecond << ", "
+			<< "\"output_bytes\": " << r.outputBytes << " }"
+			<< (i + 1 < results.size() ? ",\n" : "\n");
+	}
+	ss << "\t]\n}\n";
+	return ss.str();
+}
+
+String BenchmarkRunner::toCSV(const Vector<BenchmarkResult>& results)
+{
+	std::stringstream ss;
+	ss << std::fixed << std::setprecision(2);
+	ss << "name,iterations,repetitions,ns_per_iteration,min_ns,max_ns,bytes_per_second,output_bytes\n";
+	for (auto& r: results) {
+		ss << r.name << ',' << r.iterations << ',' << r.repetitions << ',' << r.nsPerIteration << ',' << r.minNs << ',' << r.maxNs << ',' << r.bytesPerSecond << ',' << r.outputBytes << '\n';
+	}
+	return ss.str();
+}
+
+String BenchmarkRunner::toText(const BenchmarkResult& r)
+{
+	std::stringstream ss;
+	ss << std::fixed << std::setprecision(1);
+	ss << std::left << std::setw(40) << r.name.cppStr() << std::right << std::setw(14) << r.nsPerIteration << " ns/it"
+		<< "  [" << r.minNs << " - " << r.maxNs << "]  x" << r.iterations;
+	if (r.bytesPerSecond > 0) {
+		ss << "  " << String::prettySize((long long)(r.bytesPerSecond)) << "/s";
+	}
+	if (r.outputBytes > 0) {
+		ss << "  -> " << String::prettySize((long long)(r.outputBytes));
+	}
+	return ss.str();
+}
@@ -0,0 +1,720 @@
+#include "halley/tools/benchmark/benchmark_tool.h"
+#include "halley/tools/benchmark/benchmark_runner.h"
+#include "halley/tools/file/filesystem.h"
+#include "halley/bytes/byte_serializer.h"
+#include "halley/bytes/compression.h"
+#include "halley/file_formats/config_file.h"
+#include "halley/file_formats/image.h"
+#include "halley/audio/resampler.h"
+#include "halley/audio/audio_polyphase_resampler.h"
+#include "halley/maths/matrix4.h"
+#include "halley/maths/random.h"
+#include "halley/core/resources/asset_pack.h"
+#include "halley/core/resources/asset_database.h"
+#include "halley/resources/resource.h"
+#include "halley/core/graphics/sprite/sprite.h"
+#include "halley/core/graphics/sprite/sprite_painter.h"
+#include "halley/core/graphics/material/material.h"
+#include "halley/core/graphics/material/material_definition.h"
+#include "halley/core/graphics/material/material_parameter.h"
+#include "halley/core/graphics/painter.h"
+#include "halley/core/graphics/particles/particles.h"
+#include "halley/core/resources/resources.h"
+#include "halley/core/resources/resource_locator.h"
+#include "halley/entity/world.h"
+#include "halley/entity/entity.h"
+#include "halley/entity/component.h"
+#include "halley/support/logger.h"
+#include "halley/text/string_converter.h"
+#include "../assets/importers/config_importer.h"
+#include "dummy/dummy_system.h"
+#include "dummy/dummy_video.h"
+#include <algorithm>
+#include <sstream>
+
+using namespace Halley;
+
+namespace {
+	class BenchPositionComponent : public Component
+	{
+	public:
+		constexpr static int componentIndex = 0;
+		Vector2f position;
+
+		BenchPositionComponent() {}
+		BenchPositionComponent(Vector2f position) : position(position) {}
+	};
+
+	class BenchVelocityComponent : public Component
+	{
+	public:
+		constexpr static int componentIndex = 1;
+		Vector2f velocity;
+
+		BenchVelocityComponent() {}
+		BenchVelocityComponent(Vector2f velocity) : velocity(velocity) {}
+	};
+
+	// Same shape as the families generated by codegen
+	class BenchMotionFamily : public FamilyBaseOf<BenchMotionFamily>
+	{
+	public:
+		BenchPositionComponent& position;
+		const BenchVelocityComponent& velocity;
+
+		using Type = FamilyType<BenchPositionComponent, BenchVelocityComponent>;
+
+	protected:
+		BenchMotionFamily(BenchPositionComponent& position, const BenchVelocityComponent& velocity)
+			: position(position)
+			, velocity(velocity)
+		{}
+	};
+
+	void spawnMovingEntities(World& world, size_t n, Random& rng)
+	{
+		for (size_t i = 0; i < n; ++i) {
+			world.createEntity()
+				.addComponent(BenchPositionComponent(Vector2f(rng.getFloat(0, 1000), rng.getFloat(0, 1000))))
+				.addComponent(BenchVelocityComponent(Vector2f(rng.getFloat(-1, 1), rng.getFloat(-1, 1))));
+		}
+		world.spawnPending();
+	}
+
+	void addEntityBenchmarks(BenchmarkRunner& runner)
+	{
+		runner.add("ecs/create_destroy_1k", [] () -> BenchmarkRunner::Body
+		{
+			auto world = std::make_shared<World>(nullptr, false);
+			auto& family = world->getFamily<BenchMotionFamily>();
+			auto rng = std::make_shared<Random>(1234);
+			auto ids = std::make_shared<Vector<EntityId>>();
+			return [=, &family] ()
+			{
+				spawnMovingEntities(*world, 1000, *rng);
+				ids->clear();
+				for (size_t i = 0; i < family.count(); ++i) {
+					ids->push_back(static_cast<BenchMotionFamily*>(family.getElement(i))->entityId);
+				}
+				for (auto& id: *ids) {
+					world->destroyEntity(id);
+				}
+				world->spawnPending();
+				BenchmarkRunner::consume(ids->size());
+			};
+		});
+
+		runner.add("ecs/iterate_10k", [] () -> BenchmarkRunner::Body
+		{
+			auto world = std::make_shared<World>(nullptr, false);
+			auto& family = world->getFamily<BenchMotionFamily>();
+			Random rng(1234);
+			spawnMovingEntities(*world, 10000, rng);
+			return [world, &family] ()
+			{
+				const size_t n = family.count();
+				for (size_t i = 0; i < n; ++i) {
+					auto& e = *static_cast<BenchMotionFamily*>(family.getElement(i));
+					e.position.position += e.velocity.velocity * 0.016f;
+				}
+				BenchmarkRunner::consume(uint64_t(static_cast<BenchMotionFamily*>(family.getElement(0))->position.position.x));
+			};
+		});
+	}
+
+	void addSpritePainterBenchmarks(BenchmarkRunner& runner)
+	{
+		runner.add("sprite_painter/sort_10k", [] () -> BenchmarkRunner::Body
+		{
+			constexpr size_t n = 10000;
+			auto sprites = std::make_shared<Vector<Sprite>>(n);
+			auto source = std::make_shared<Vector<SpritePainterEntry>>();
+			auto work = std::make_shared<Vector<SpritePainterEntry>>();
+			Random rng(1234);
+			source->reserve(n);
+			for (auto& s: *sprites) {
+				s.setPos(Vector2f(rng.getFloat(0, 1920), rng.getFloat(0, 1080)));
+				source->emplace_back(s, 1, rng.getInt(0, 7), s.getPosition().y);
+			}
+			return [sprites, source, work] ()
+			{
+				*work = *source;
+				std::sort(work->begin(), work->end());
+				BenchmarkRunner::consume(work->front().getMask());
+			};
+		});
+	}
+
+	std::shared_ptr<MaterialDefinition> makeMaterialDefinition(const String& yaml)
+	{
+		ConfigFile config;
+		ConfigImporter::parseConfig(config, gsl::as_bytes(gsl::span<const char>(yaml.c_str(), yaml.size())));
+		auto definition = std::make_shared<MaterialDefinition>();
+		definition->load(config.getRoot());
+		return definition;
+	}
+
+	// Painter on top of the dummy video plugin, so batching, vertex copies and index generation are measured without a GPU.
+	// Materials have the Halley/SpriteBase vertex layout and a single pass, but no uniform blocks, since those need a video API to back them.
+	class BenchPainter
+	{
+	public:
+		BenchPainter()
+			: video(system)
+			, resources(std::unique_ptr<ResourceLocator>(), nullptr)
+		{
+			resources.init<MaterialDefinition>();
+			resources.of<MaterialDefinition>().setResource(0, "Halley/MaterialBase", makeMaterialDefinition("name: Halley/MaterialBase\n"));
+			painter = video.makePainter(resources);
+		}
+
+		std::shared_ptr<Material> makeSpriteMaterial(const String& name)
+		{
+			auto definition = makeMaterialDefinition("name: " + name + "\n"
+				"attributes:\n"
+				"  - a_vertPos: vec4\n"
+				"  - a_position: vec2\n"
+				"  - a_pivot: vec2\n"
+				"  - a_size: vec2\n"
+				"  - a_scale: vec2\n"
+				"  - a_colour: vec4\n"
+				"  - a_texCoord0: vec4\n"
+				"  - a_rotation: float\n"
+				"  - a_textureRotation: float\n");
+			ConfigFile pass;
+			const String passYaml = "blend: Alpha\n";
+			ConfigImporter::parseConfig(pass, gsl::as_bytes(gsl::span<const char>(passYaml.c_str(), passYaml.size())));
+			definition->addPass(MaterialPass("", pass.getRoot()));
+			return std::make_shared<Material>(definition);
+		}
+
+		Painter& getPainter() { return *painter; }
+
+	private:
+		DummySystemAPI system;
+		DummyVideoAPI video;
+		Resources resources;
+		std::unique_ptr<Painter> painter;
+	};
+
+	std::shared_ptr<Vector<Sprite>> makeBenchSprites(size_t n, const Vector<std::shared_ptr<Material>>& materials)
+	{
+		auto sprites = std::make_shared<Vector<Sprite>>(n);
+		Random rng(1234);
+		for (size_t i = 0; i < n; ++i) {
+			(*sprites)[i]
+				.setMaterial(materials[i % materials.size()])
+				.setSize(Vector2f(32, 32))
+				.setPos(Vector2f(rng.getFloat(0, 1920), rng.getFloat(0, 1080)));
+		}
+		return sprites;
+	}
+
+	void addPainterBenchmarks(BenchmarkRunner& runner)
+	{
+		constexpr size_t numSprites = 10000;
+
+		runner.add("painter/draw_sprites_10k", [=] () -> BenchmarkRunner::Body
+		{
+			auto bench = std::make_shared<BenchPainter>();
+			auto sprites = makeBenchSprites(numSprites, { bench->makeSpriteMaterial("bench/sprite") });
+			return [bench, sprites] ()
+			{
+				auto& painter = bench->getPainter();
+				for (auto& s: *sprites) {
+					s.draw(painter);
+				}
+				painter.flush();
+				BenchmarkRunner::consume(painter.getNumDrawCalls());
+			};
+		});
+
+		// Worst case for batching: every sprite breaks the batch
+		runner.add("painter/draw_sprites_10k_alternating", [=] () -> BenchmarkRunner::Body
+		{
+			auto bench = std::make_shared<BenchPainter>();
+			auto sprites = makeBenchSprites(numSprites, { bench->makeSpriteMaterial("bench/spriteA"), bench->makeSpriteMaterial("bench/spriteB") });
+			return [bench, sprites] ()
+			{
+				auto& painter = bench->getPainter();
+				for (auto& s: *sprites) {
+					s.draw(painter);
+				}
+				painter.flush();
+				BenchmarkRunner::consume(painter.getNumDrawCalls());
+			};
+		});
+
+		// More vertices than 16-bit indices can address, submitted in a single call
+		runner.add("painter/draw_sprites_50k_bulk", [=] () -> BenchmarkRunner::Body
+		{
+			auto bench = std::make_shared<BenchPainter>();
+			auto sprites = makeBenchSprites(50000, { bench->makeSpriteMaterial("bench/sprite") });
+			return [bench, sprites] ()
+			{
+				auto& painter = bench->getPainter();
+				Sprite::draw(sprites->data(), sprites->size(), painter);
+				painter.flush();
+				BenchmarkRunner::consume(painter.getNumDrawCalls());
+			};
+		});
+
+		runner.add("painter/draw_particles_100k", [=] () -> BenchmarkRunner::Body
+		{
+			auto bench = std::make_shared<BenchPainter>();
+			ParticleEmitterConfig config;
+			config.maxParticles = 100000;
+			config.lifetime = Range<float>(1000.0f, 1000.0f);
+			config.spawnArea = Vector2f(960, 540);
+			auto emitter = std::make_shared<ParticleEmitter>(config, Sprite().setMaterial(bench->makeSpriteMaterial("bench/particle")).setSize(Vector2f(8, 8)));
+			emitter->setEnabled(false);
+			emitter->burst(config.maxParticles);
+			return [bench, emitter] ()
+			{
+				auto& painter = bench->getPainter();
+				emitter->draw(painter);
+				painter.flush();
+				BenchmarkRunner::consume(painter.getNumDrawCalls());
+			};
+		});
+	}
+
+	void addSerializationBenchmarks(BenchmarkRunner& runner)
+	{
+		constexpr size_t numInts = 64 * 1024;
+		constexpr size_t numStrings = 4096;
+
+		runner.add("serializer/write_ints_64k", [=] () -> BenchmarkRunner::Body
+		{
+			auto values = std::make_shared<std::vector<int>>(numInts);
+			for (size_t i = 0; i < numInts; ++i) {
+				(*values)[i] = int(i * 2654435761u);
+			}
+			return [values] ()
+			{
+				BenchmarkRunner::consume(Serializer::toBytes(*values).size());
+			};
+		}, numInts * sizeof(int));
+
+		runner.add("serializer/write_ints_64k_reuse", [=] () -> BenchmarkRunner::Body
+		{
+			auto values = std::make_shared<std::vector<int>>(numInts);
+			for (size_t i = 0; i < numInts; ++i) {
+				(*values)[i] = int(i * 2654435761u);
+			}
+			auto buffer = std::make_shared<Bytes>();
+			return [values, buffer] ()
+			{
+				Serializer::toBytes(*values, *buffer);
+				BenchmarkRunner::consume(buffer->size());
+			};
+		}, numInts * sizeof(int));
+
+		runner.add("serializer/read_ints_64k", [=] () -> BenchmarkRunner::Body
+		{
+			std::vector<int> values(numInts);
+			for (size_t i = 0; i < numInts; ++i) {
+				values[i] = int(i * 2654435761u);
+			}
+			auto bytes = std::make_shared<Bytes>(Serializer::toBytes(values));
+			return [bytes] ()
+			{
+				BenchmarkRunner::consume(Deserializer::fromBytes<std::vector<int>>(*bytes).size());
+			};
+		}, numInts * sizeof(int));
+
+		runner.add("serializer/write_strings_4k", [=] () -> BenchmarkRunner::Body
+		{
+			auto values = std::make_shared<std::vector<String>>();
+			for (size_t i = 0; i < numStrings; ++i) {
+				values->push_back("entity_name_" + toString(i));
+			}
+			return [values] ()
+			{
+				BenchmarkRunner::consume(Serializer::toBytes(*values).size());
+			};
+		});
+
+		runner.add("serializer/read_strings_4k", [=] () -> BenchmarkRunner::Body
+		{
+			std::vector<String> values;
+			for (size_t i = 0; i < numStrings; ++i) {
+				values.push_back("entity_name_" + toString(i));
+			}
+			auto bytes = std::make_shared<Bytes>(Serializer::toBytes(values));
+			return [bytes] ()
+			{
+				BenchmarkRunner::consume(Deserializer::fromBytes<std::vector<String>>(*bytes).size());
+			};
+		});
+	}
+
+	Bytes makeCompressibleData(size_t size)
+	{
+		// Random words from a small dictionary, compresses about as well as typical asset metadata
+		const char* words[] = { "sprite", "position", "velocity", "layer", "material", "texture", "animation", "frame", " ", "\n" };
+		Random rng(1234);
+		Bytes result;
+		result.reserve(size + 16);
+		while (result.size() < size) {
+			for (const char* c = words[rng.getInt(0, 9)]; *c; ++c) {
+				result.push_back(Byte(*c));
+			}
+		}
+		result.resize(size);
+		return result;
+	}
+
+	void addCompressionBenchmarks(BenchmarkRunner& runner)
+	{
+		constexpr size_t size = 1024 * 1024;
+
+		runner.add("compression/compress_1mb", [=] () -> BenchmarkRunner::Body
+		{
+			auto data = std::make_shared<Bytes>(makeCompressibleData(size));
+			return [data] ()
+			{
+				BenchmarkRunner::consume(Compression::compress(*data).size());
+			};
+		}, size);
+
+		runner.add("compression/compress_fast_1mb", [=] () -> BenchmarkRunner::Body
+		{
+			auto data = std::make_shared<Bytes>(makeCompressibleData(size));
+			return [data] ()
+			{
+				BenchmarkRunner::consume(Compression::compress(*data, CompressionLevel::Fast).size());
+			};
+		}, size);
+
+		runner.add("compression/compress_small_reuse", [=] () -> BenchmarkRunner::Body
+		{
+			auto data = std::make_shared<Bytes>(makeCompressibleData(512));
+			auto out = std::make_shared<Bytes>();
+			return [data, out] ()
+			{
+				out->clear();
+				Compression::compressRaw(gsl::as_bytes(gsl::span<const Byte>(*data)), *out, false);
+				BenchmarkRunner::consume(out->size());
+			};
+		}, 512);
+
+		runner.add("compression/decompress_1mb", [=] () -> BenchmarkRunner::Body
+		{
+			auto data = std::make_shared<Bytes>(Compression::compress(makeCompressibleData(size)));
+			return [data] ()
+			{
+				BenchmarkRunner::consume(Compression::decompress(*data).size());
+			};
+		}, size);
+
+		runner.add("compression/decompress_shared_1mb", [=] () -> BenchmarkRunner::Body
+		{
+			auto data = std::make_shared<Bytes>(Compression::compress(makeCompressibleData(size)));
+			return [data] ()
+			{
+				size_t outSize = 0;
+				auto result = Compression::decompressToSharedPtr(gsl::as_bytes(gsl::span<const Byte>(*data)), outSize);
+				BenchmarkRunner::consume(outSize);
+			};
+		}, size);
+	}
+
+	std::shared_ptr<Image> makeBenchImage(Vector2i size)
+	{
+		// Smooth gradients with some noise, roughly what a rendered screenshot or a painted sprite sheet compresses like
+		auto image = std::make_shared<Image>(Image::Format::RGBA, size);
+		auto px = reinterpret_cast<uint32_t*>(image->getPixels());
+		Random rng(1234);
+		for (int y = 0; y < size.y; ++y) {
+			for (int x = 0; x < size.x; ++x) {
+				const int noise = rng.getInt(0, 7);
+				const uint32_t r = uint32_t((x * 255 / size.x + noise) & 0xFF);
+				const uint32_t g = uint32_t((y * 255 / size.y + noise) & 0xFF);
+				const uint32_t b = uint32_t(((x + y) / 16) & 0xFF);
+				px[y * size.x + x] = r | (g << 8) | (b << 16) | 0xFF000000u;
+			}
+		}
+		return image;
+	}
+
+	void addImageBenchmarks(BenchmarkRunner& runner)
+	{
+		const auto size = Vector2i(3840, 2160);
+		const std::pair<const char*, Image::PNGEncoding> encodings[] = {
+			{ "small", Image::PNGEncoding::Small },
+			{ "fast", Image::PNGEncoding::Fast }
+		};
+
+		for (auto& e: encodings) {
+			const auto encoding = e.second;
+			runner.add(String("png/encode_") + e.first + "_4k", [=] () -> BenchmarkRunner::Body
+			{
+				auto image = makeBenchImage(size);
+				return [image, encoding] ()
+				{
+					const auto bytes = image->savePNGToBytes(false, encoding);
+					BenchmarkRunner::reportOutputBytes(bytes.size());
+					BenchmarkRunner::consume(bytes.size());
+				};
+			}, size_t(size.x) * size_t(size.y) * 4);
+		}
+	}
+
+	String makeConfigYAML(size_t numEntries)
+	{
+		std::stringstream ss;
+		ss << "entities:\n";
+		for (size_t i = 0; i < numEntries; ++i) {
+			ss << "  - name: entity" << i << "\n"
+				<< "    position: [" << (i * 16) << ", " << (i * 8) << "]\n"
+				<< "    layer: " << (i % 8) << "\n"
+				<< "    speed: " << (float(i) * 0.25f) << "\n"
+				<< "    tags: [enemy, flying, boss" << i << "]\n";
+		}
+		return ss.str();
+	}
+
+	void addConfigBenchmarks(BenchmarkRunner& runner)
+	{
+		constexpr size_t numEntries = 500;
+
+		runner.add("config/parse_yaml_500", [=] () -> BenchmarkRunner::Body
+		{
+			auto yaml = std::make_shared<String>(makeConfigYAML(numEntries));
+			return [yaml] ()
+			{
+				ConfigFile config;
+				ConfigImporter::parseConfig(config, gsl::as_bytes(gsl::span<const char>(yaml->c_str(), yaml->size())));
+				BenchmarkRunner::consume(config.getRoot()["entities"].asSequence().size());
+			};
+		});
+
+		runner.add("config/serialize_500", [=] () -> BenchmarkRunner::Body
+		{
+			auto config = std::make_shared<ConfigFile>();
+			const auto yaml = makeConfigYAML(numEntries);
+			ConfigImporter::parseConfig(*config, gsl::as_bytes(gsl::span<const char>(yaml.c_str(), yaml.size())));
+			return [config] ()
+			{
+				BenchmarkRunner::consume(Serializer::toBytes(*config).size());
+			};
+		});
+
+		runner.add("config/deserialize_500", [=] () -> BenchmarkRunner::Body
+		{
+			ConfigFile config;
+			const auto yaml = makeConfigYAML(numEntries);
+			ConfigImporter::parseConfig(config, gsl::as_bytes(gsl::span<const char>(yaml.c_str(), yaml.size())));
+			auto bytes = std::make_shared<Bytes>(Serializer::toBytes(config));
+			return [bytes] ()
+			{
+				ConfigFile result;
+				Deserializer::fromBytes(result, *bytes);
+				BenchmarkRunner::consume(result.getRoot()["entities"].asSequence().size());
+			};
+		});
+	}
+
+	// Serves an asset pack from memory, so pack reads are measured without disk noise
+	class MemoryDataReader : public ResourceDataReader
+	{
+	public:
+		explicit MemoryDataReader(std::shared_ptr<const Bytes> data)
+			: data(std::move(data))
+		{}
+
+		size_t size() const override { return data->size(); }
+
+		int read(gsl::span<gsl::byte> dst) override
+		{
+			const size_t n = std::min(size_t(dst.size()), data->size() - pos);
+			memcpy(dst.data(), data->data() + pos, n);
+			pos += n;
+			return int(n);
+		}
+
+		void seek(int64_t offset, int whence) override
+		{
+			if (whence == SEEK_SET) {
+				pos = size_t(offset);
+			} else if (whence == SEEK_CUR) {
+				pos = size_t(int64_t(pos) + offset);
+			} else if (whence == SEEK_END) {
+				pos = size_t(int64_t(data->size()) + offset);
+			}
+			pos = std::min(pos, data->size());
+		}
+
+		size_t tell() const override { return pos; }
+		void close() override {}
+
+	private:
+		std::shared_ptr<const Bytes> data;
+		size_t pos = 0;
+	};
+
+	std::shared_ptr<const Bytes> makeAssetPack(size_t numAssets, size_t assetSize)
+	{
+		AssetPack pack;
+		auto& data = pack.getData();
+		const auto payload = makeCompressibleData(assetSize);
+		for (size_t i = 0; i < numAssets; ++i) {
+			const size_t pos = data.size();
+			data.insert(data.end(), payload.begin(), payload.end());
+			pack.getAssetDatabase().addAsset("asset" + toString(i), AssetType::BinaryFile, AssetDatabase::Entry(toString(pos) + ":" + toString(assetSize), Metadata()));
+		}
+		return std::make_shared<const Bytes>(pack.writeOut());
+	}
+
+	void addAssetPackBenchmarks(BenchmarkRunner& runner)
+	{
+		constexpr size_t numAssets = 256;
+		constexpr size_t assetSize = 16 * 1024;
+
+		runner.add("asset_pack/open_256", [=] () -> BenchmarkRunner::Body
+		{
+			auto packData = makeAssetPack(numAssets, assetSize);
+			return [packData] ()
+			{
+				AssetPack pack(std::make_unique<MemoryDataReader>(packData));
+				BenchmarkRunner::consume(pack.getAssetDatabase().getDatabase(AssetType::BinaryFile).getAssets().size());
+			};
+		});
+
+		runner.add("asset_pack/read_256x16k", [=] () -> BenchmarkRunner::Body
+		{
+			auto pack = std::make_shared<AssetPack>(std::make_unique<MemoryDataReader>(makeAssetPack(numAssets, assetSize)));
+			auto names = std::make_shared<Vector<String>>();
+			for (size_t i = 0; i < numAssets; ++i) {
+				names->push_back("asset" + toString(i));
+			}
+			return [pack, names] ()
+			{
+				for (auto& name: *names) {
+					auto data = pack->getData(name, AssetType::BinaryFile, false);
+					BenchmarkRunner::consume(static_cast<ResourceDataStatic&>(*data).getSize());
+				}
+			};
+		}, numAssets * assetSize);
+	}
+
+	void addAudioBenchmarks(BenchmarkRunner& runner)
+	{
+		// One second of stereo audio at 44.1 kHz, resampled to the 48 kHz output rate
+		constexpr size_t numSamples = 44100 * 2;
+
+		runner.add("audio/resample_1s_stereo", [=] () -> BenchmarkRunner::Body
+		{
+			auto resampler = std::make_shared<AudioResampler>(44100, 48000, 2);
+			auto src = std::make_shared<Vector<float>>(numSamples);
+			auto dst = std::make_shared<Vector<float>>(resampler->numOutputSamples(numSamples) + 64);
+			Random rng(1234);
+			rng.getFloats(gsl::span<float>(*src), -1.0f, 1.0f);
+			return [resampler, src, dst] ()
+			{
+				auto result = resampler->resampleInterleaved(gsl::span<const float>(*src), gsl::span<float>(*dst));
+				BenchmarkRunner::consume(result.nWritten);
+			};
+		}, numSamples * sizeof(float));
+
+		// Same workload through the per-emitter polyphase resampler, one instance per channel as AudioFilterResample uses it
+		const std::pair<const char*, AudioResamplerQuality> qualities[] = {
+			{ "fast", AudioResamplerQuality::Fast },
+			{ "normal", AudioResamplerQuality::Normal },
+			{ "high", AudioResamplerQuality::High }
+		};
+		for (auto& q: qualities) {
+			const auto quality = q.second;
+			runner.add(String("audio/resample_polyphase_") + q.first + "_1s_stereo", [=] () -> BenchmarkRunner::Body
+			{
+				constexpr size_t numChannels = 2;
+				constexpr size_t samplesPerChannel = numSamples / numChannels;
+				auto resamplers = std::make_shared<Vector<AudioPolyphaseResampler>>();
+				auto src = std::make_shared<Vector<Vector<float>>>(numChannels, Vector<float>(samplesPerChannel));
+				auto dst = std::make_shared<Vector<float>>(samplesPerChannel * 48000 / 44100 + 256);
+				Random rng(1234);
+				for (auto& channel: *src) {
+					resamplers->emplace_back(44100.0f / 48000.0f, quality);
+					rng.getFloats(gsl::span<float>(channel), -1.0f, 1.0f);
+				}
+				return [resamplers, src, dst] ()
+				{
+					size_t written = 0;
+					for (size_t i = 0; i < numChannels; ++i) {
+						written += (*resamplers)[i].resample(gsl::span<const float>((*src)[i]), gsl::span<float>(*dst));
+					}
+					BenchmarkRunner::consume(written);
+				};
+			}, numSamples * sizeof(float));
+		}
+	}
+
+	void addMathsBenchmarks(BenchmarkRunner& runner)
+	{
+		constexpr size_t numPoints = 4096;
+
+		runner.add("maths/transform_points_4k", [=] () -> BenchmarkRunner::Body
+		{
+			auto points = std::make_shared<Vector<Vector2f>>(numPoints);
+			auto dst = std::make_shared<Vector<Vector2f>>(numPoints);
+			Random rng(1234);
+			for (auto& p: *points) {
+				p = Vector2f(rng.getFloat(-1000, 1000), rng.getFloat(-1000, 1000));
+			}
+			auto m = std::make_shared<Matrix4f>(Matrix4f::makeTranslation2D(100, 50) * Matrix4f::makeRotationZ(Angle1f::fromDegrees(30)) * Matrix4f::makeScaling2D(2, 2));
+			return [points, dst, m] ()
+			{
+				m->transformPoints(gsl::span<const Vector2f>(*points), gsl::span<Vector2f>(*dst));
+				BenchmarkRunner::consume(uint64_t((*dst)[0].x));
+			};
+		});
+	}
+}
+
+void BenchmarkTool::addEngineBenchmarks(BenchmarkRunner& runner)
+{
+	addEntityBenchmarks(runner);
+	addSpritePainterBenchmarks(runner);
+	addPainterBenchmarks(runner);
+	addSerializationBenchmarks(runner);
+	addCompressionBenchmarks(runner);
+	addImageBenchmarks(runner);
+	addConfigBenchmarks(runner);
+	addAssetPackBenchmarks(runner);
+	addAudioBenchmarks(runner);
+	addMathsBenchmarks(runner);
+}
+
+int BenchmarkTool::run(Vector<std::string> args)
+{
+	if (args.size() > 3) {
+		std::cout << "Usage: halley-cmd benchmark [filter] [results.json|results.csv] [minTimeSeconds]" << std::endl;
+		return 1;
+	}
+
+	const String filter = args.size() > 0 ? String(args[0]) : String("all");
+	const auto outPath = args.size() > 1 ? Maybe<Path>(Path(args[1])) : Maybe<Path>();
+	const Time minTime = args.size() > 2 ? Time(String(args[2]).toFloat()) : 0.1;
+
+	BenchmarkRunner runner(minTime);
+	addEngineBenchmarks(runner);
+
+	auto results = runner.run(filter, [] (const BenchmarkResult& result)
+	{
+		Logger::logInfo(BenchmarkRunner::toText(result));
+	});
+
+	if (results.empty()) {
+		Logger::logError("No benchmarks match \"" + filter + "\"");
+		return 1;
+	}
+
+	if (outPath) {
+		const auto str = outPath->getExtension() == ".csv" ? BenchmarkRunner::toCSV(results) : BenchmarkRunner::toJSON(results);
+		FileSystem::writeFile(outPath.get(), gsl::as_bytes(gsl::span<const char>(str.c_str(), str.size())));
+		Logger::logInfo("Wrote " + toString(results.size()) + " results to " + outPath->string());
+	}
+
+	return 0;
+}
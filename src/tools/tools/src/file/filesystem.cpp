@@ -134,7 +134,7 @@ size_t FileSystem::fileSize(const Path& path)
 
 Path FileSystem::getTemporaryPath() 
 {
-	auto& rng = Random::getGlobal();
+	auto& rng = Random::getThreadLocal();
 	std::array<char, 16> name;
 	const std::array<char, 16> digits = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f' };
 	for (size_t i = 0; i < name.size(); ++i) {
@@ -6,6 +6,7 @@
 #include "halley/tools/packer/asset_pack_manifest.h"
 #include "halley/resources/resource.h"
 #include "halley/core/resources/asset_pack.h"
+#include "halley/core/resources/prefetch_manifest.h"
 #include "halley/tools/project/project.h"
 #include "halley/tools/assets/import_assets_database.h"
 using namespace Halley;
@@ -51,9 +52,24 @@ bool AssetPackListing::isActive() const
 	return active;
 }
 
-void AssetPackListing::sort()
+void AssetPackListing::sort(const std::map<String, size_t>& accessOrder)
 {
-	std::sort(entries.begin(), entries.end());
+	// Assets recorded in prefetch manifests go first, in the order they were accessed, so loading reads the pack sequentially
+	auto getOrder = [&] (const Entry& e) -> size_t
+	{
+		const auto iter = accessOrder.find(toString(e.type) + ":" + e.name);
+		return iter != accessOrder.end() ? iter->second : std::numeric_limits<size_t>::max();
+	};
+
+	std::sort(entries.begin(), entries.end(), [&] (const Entry& a, const Entry& b)
+	{
+		const size_t orderA = getOrder(a);
+		const size_t orderB = getOrder(b);
+		if (orderA != orderB) {
+			return orderA < orderB;
+		}
+		return a < b;
+	});
 }
 
 void AssetPacker::pack(Project& project, Maybe<std::set<String>> assetsToPack, const std::vector<String>& deletedAssets)
@@ -73,13 +89,38 @@ void AssetPacker::packPlatform(Project& project, Maybe<std::set<String>> assetsT
 	const auto manifest = AssetPackManifest(FileSystem::readFile(project.getAssetPackManifestPath()));
 
 	// Sort into packs
-	const std::map<String, AssetPackListing> packs = sortIntoPacks(manifest, *db, assetsToPack, deletedAssets);
+	const std::map<String, AssetPackListing> packs = sortIntoPacks(manifest, *db, getAccessOrder(*db, src), assetsToPack, deletedAssets);
 
 	// Generate packs
 	generatePacks(packs, src, dst);
 }
 
-std::map<String, AssetPackListing> AssetPacker::sortIntoPacks(const AssetPackManifest& manifest, const AssetDatabase& srcAssetDb, Maybe<std::set<String>> assetsToPack, const std::vector<String>& deletedAssets)
+std::map<String, size_t> AssetPacker::getAccessOrder(const AssetDatabase& srcAssetDb, const Path& src)
+{
+	// Prefetch manifests are binary files named *.prefetch, recorded with Resources::startRecordingAccesses
+	std::map<String, const AssetDatabase::Entry*> manifests;
+	for (auto& assetEntry: srcAssetDb.getDatabase(AssetType::BinaryFile).getAssets()) {
+		if (assetEntry.first.endsWith(".prefetch")) {
+			manifests[assetEntry.first] = &assetEntry.second;
+		}
+	}
+
+	std::map<String, size_t> result;
+	for (auto& m: manifests) {
+		auto entries = Deserializer::fromBytes<PrefetchManifest>(FileSystem::readFile(src / m.second->path)).getEntries();
+		std::stable_sort(entries.begin(), entries.end(), [] (const PrefetchManifest::Entry& a, const PrefetchManifest::Entry& b) { return a.time < b.time; });
+		for (auto& e: entries) {
+			const auto key = toString(e.type) + ":" + e.assetId;
+			if (result.find(key) == result.end()) {
+				const size_t order = result.size();
+				result[key] = order;
+			}
+		}
+	}
+	return result;
+}
+
+std::map<String, AssetPackListing> AssetPacker::sortIntoPacks(const AssetPackManifest& manifest, const AssetDatabase& srcAssetDb, const std::map<String, size_t>& accessOrder, Maybe<std::set<String>> assetsToPack, const std::vector<String>& deletedAssets)
 {
 	std::map<String, AssetPackListing> packs;
 	for (auto typeName: EnumNames<AssetType>()()) {
@@ -124,7 +165,7 @@ std::map<String, AssetPackListing> AssetPacker::sortIntoPacks(const AssetPackMan
 
 	// Sort all packs
 	for (auto& p: packs) {
-		p.second.sort();
+		p.second.sort(accessOrder);
 	}
 
 	// Activate any packs that contain deleted assets